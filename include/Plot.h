@@ -0,0 +1,450 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "frequency_response.h"
+#include "transform_registry.h"
+
+// Function being plotted. Immutable once built, so the worker thread can hold on to it
+// while the GUI moves on to the next expression.
+struct PlotContent {
+    std::vector<ParsedTerm> terms;
+    Laplace::FrequencyEvaluator evaluator;
+    double maxOmega = 0; // Fastest oscillation in f(t), used to pick the time sample density
+
+    PlotContent(const std::vector<ParsedTerm>& t, const std::vector<Laplace::RationalFunction>& transforms)
+        : terms(t), evaluator(transforms) {
+        for (const ParsedTerm& term : terms) {
+            if (Laplace::transform_entry(term.type).signature.oscillation != FunctionType::UNRECOGNIZED) {
+                maxOmega = std::max(maxOmega, std::fabs(term.parameters[term.parameters.size() - 1]));
+            }
+        }
+    }
+};
+
+// Samples computed by the worker for one plot over [from, to].
+struct PlotSamples {
+    unsigned generation;
+    double from, to;
+    std::vector<double> x;
+    std::vector<std::vector<double>> y; // One row per curve
+};
+
+struct PlotRequest {
+    std::shared_ptr<const PlotContent> content;
+    unsigned generation;
+    double from, to;
+    size_t samples;
+};
+
+struct PlotCurve {
+    sf::VertexArray vertices{sf::Lines};
+    sf::Color color;
+    double yMin = -1, yMax = 1;
+};
+
+// One plot area. Curves share the x axis and each has its own y range. Vertices are kept in
+// data coordinates (x relative to origin, so floats keep their precision when zoomed in) and
+// drawn through an sf::View, so panning and zooming only move the view; the vertices are
+// rebuilt when the worker delivers samples for the new range.
+class Plot {
+public:
+    sf::FloatRect area;
+    double xMin, xMax;                         // Visible range
+    double requestedFrom = 0, requestedTo = 0; // Range of the newest samples asked for
+    double origin = 0;
+    bool logX;
+    std::vector<PlotCurve> curves;
+
+    sf::RectangleShape frame;
+    sf::RectangleShape zeroLine;
+    std::vector<sf::Text> titles;
+    sf::Text leftLabel, rightLabel, topLabel, bottomLabel;
+
+    Plot(const sf::FloatRect& a, double from, double to, bool logScale, const sf::Font& font,
+         const std::vector<std::pair<std::string, sf::Color>>& curveTitles)
+        : area(a), xMin(from), xMax(to), logX(logScale) {
+        frame.setPosition(area.left, area.top);
+        frame.setSize({area.width, area.height});
+        frame.setFillColor(sf::Color(30, 30, 30));
+        frame.setOutlineColor(sf::Color::Black);
+        frame.setOutlineThickness(2);
+
+        zeroLine.setSize({area.width, 1});
+        zeroLine.setFillColor(sf::Color(90, 90, 90));
+
+        float titleX = area.left + 6;
+        for (const auto& curveTitle : curveTitles) {
+            PlotCurve curve;
+            curve.color = curveTitle.second;
+            curves.push_back(curve);
+
+            sf::Text title(curveTitle.first, font, 14);
+            title.setFillColor(curveTitle.second);
+            title.setPosition(titleX, area.top + 4);
+            titleX += title.getLocalBounds().width + 16;
+            titles.push_back(title);
+        }
+
+        for (sf::Text* label : {&leftLabel, &rightLabel, &topLabel, &bottomLabel}) {
+            label->setFont(font);
+            label->setCharacterSize(12);
+            label->setFillColor(sf::Color(200, 200, 200));
+        }
+    }
+
+    bool contains(float x, float y) const {
+        return area.contains(x, y);
+    }
+
+    // Data x under screen column px.
+    double xAt(float px) const {
+        return xMin + (px - area.left) / area.width * (xMax - xMin);
+    }
+
+    // Narrowest and widest visible x range: narrower is all one sample, wider overflows
+    // 10^x on the log axis or spreads the samples too thin to show anything.
+    static constexpr double kMinSpan = 1e-6;
+    double maxSpan() const { return logX ? 30.0 : 1e6; }
+
+    void zoom(float px, double factor) {
+        double span = xMax - xMin;
+        factor = std::min(std::max(span * factor, kMinSpan), maxSpan()) / span;
+        double anchor = xAt(px);
+        xMin = anchor + (xMin - anchor) * factor;
+        xMax = anchor + (xMax - anchor) * factor;
+    }
+
+    void pan(float dx) {
+        double shift = dx / area.width * (xMax - xMin);
+        xMin -= shift;
+        xMax -= shift;
+    }
+
+    // The samples in hand no longer cover the view, or are too sparse or too dense for it.
+    bool needsSamples() const {
+        double span = xMax - xMin, covered = requestedTo - requestedFrom;
+        return xMin < requestedFrom || xMax > requestedTo || covered > 6 * span || covered < 1.5 * span;
+    }
+
+    // Replaces the curves with new samples and fits each y range to what is visible.
+    void setSamples(const PlotSamples& samples) {
+        origin = samples.from;
+        for (size_t c = 0; c < curves.size(); ++c) {
+            PlotCurve& curve = curves[c];
+            const std::vector<double>& y = samples.y[c];
+            curve.vertices.clear();
+
+            double low = INFINITY, high = -INFINITY;
+            for (size_t i = 0; i < y.size(); ++i) {
+                if (!usable(y[i])) continue;
+                if (samples.x[i] >= xMin && samples.x[i] <= xMax) {
+                    low = std::min(low, y[i]);
+                    high = std::max(high, y[i]);
+                }
+                // sf::Lines rather than a strip, so a pole or overflow leaves a gap
+                if (i + 1 < y.size() && usable(y[i + 1])) {
+                    curve.vertices.append(sf::Vertex(point(samples.x[i], y[i]), curve.color));
+                    curve.vertices.append(sf::Vertex(point(samples.x[i + 1], y[i + 1]), curve.color));
+                }
+            }
+            if (low > high) {
+                low = -1;
+                high = 1;
+            } else if (high - low < 1e-9 * std::max(1.0, std::fabs(high))) {
+                low -= 1;
+                high += 1;
+            }
+            double margin = 0.05 * (high - low);
+            curve.yMin = low - margin;
+            curve.yMax = high + margin;
+        }
+    }
+
+    void clear() {
+        for (PlotCurve& curve : curves) {
+            curve.vertices.clear();
+        }
+        requestedFrom = requestedTo = 0;
+    }
+
+    void draw(sf::RenderWindow& window) {
+        window.draw(frame);
+
+        if (!curves.empty() && curves[0].vertices.getVertexCount() > 0) {
+            const PlotCurve& first = curves[0];
+            if (first.yMin < 0 && first.yMax > 0) {
+                float y = area.top + static_cast<float>(first.yMax / (first.yMax - first.yMin)) * area.height;
+                zeroLine.setPosition(area.left, y);
+                window.draw(zeroLine);
+            }
+        }
+
+        sf::Vector2u size = window.getSize();
+        for (const PlotCurve& curve : curves) {
+            sf::View view(sf::FloatRect(static_cast<float>(xMin - origin), static_cast<float>(curve.yMax),
+                                        static_cast<float>(xMax - xMin), static_cast<float>(curve.yMin - curve.yMax)));
+            view.setViewport(sf::FloatRect(area.left / size.x, area.top / size.y,
+                                           area.width / size.x, area.height / size.y));
+            window.setView(view);
+            window.draw(curve.vertices);
+        }
+        window.setView(window.getDefaultView());
+
+        updateLabels();
+        for (const sf::Text& title : titles) {
+            window.draw(title);
+        }
+        window.draw(leftLabel);
+        window.draw(rightLabel);
+        window.draw(topLabel);
+        window.draw(bottomLabel);
+    }
+
+private:
+    static bool usable(double value) {
+        return std::isfinite(value) && std::fabs(value) < 1e30;
+    }
+
+    sf::Vector2f point(double x, double y) const {
+        return {static_cast<float>(x - origin), static_cast<float>(y)};
+    }
+
+    static std::string format(double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof buffer, "%.3g", value);
+        return buffer;
+    }
+
+    void updateLabels() {
+        leftLabel.setString(logX ? "1e" + format(xMin) : format(xMin));
+        rightLabel.setString(logX ? "1e" + format(xMax) : format(xMax));
+        leftLabel.setPosition(area.left + 4, area.top + area.height - 16);
+        rightLabel.setPosition(area.left + area.width - rightLabel.getLocalBounds().width - 6,
+                               area.top + area.height - 16);
+
+        if (!curves.empty()) {
+            topLabel.setString(format(curves[0].yMax));
+            bottomLabel.setString(format(curves[0].yMin));
+        }
+        topLabel.setPosition(area.left + area.width - topLabel.getLocalBounds().width - 6, area.top + 4);
+        bottomLabel.setPosition(area.left + area.width - bottomLabel.getLocalBounds().width - 6,
+                                area.top + area.height - 30);
+    }
+};
+
+// Bode magnitude/phase of F(jw) above f(t), next to the input box.
+// Drag pans and the mouse wheel zooms along x. Sampling runs on a worker thread: the GUI
+// thread only asks for a range and picks up finished samples in update(), so it keeps
+// drawing at the frame rate however long a resample takes.
+class PlotPanel {
+public:
+    PlotPanel(const sf::Font& font, const sf::FloatRect& area)
+        : bode(sf::FloatRect(area.left, area.top, area.width, area.height / 2 - 5), -2, 3, true, font,
+               {{"|F(jw)| dB", sf::Color(66, 135, 245)}, {"phase deg", sf::Color(244, 187, 68)}}),
+          time(sf::FloatRect(area.left, area.top + area.height / 2 + 5, area.width, area.height / 2 - 5), 0, 10,
+               false, font, {{"f(t)", sf::Color(80, 200, 120)}}),
+          worker_([this] { run(); }) {
+    }
+
+    ~PlotPanel() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        worker_.join();
+    }
+
+    PlotPanel(const PlotPanel&) = delete;
+    PlotPanel& operator=(const PlotPanel&) = delete;
+
+    // Plots a new expression; empty vectors clear the panel.
+    void setFunction(const std::vector<ParsedTerm>& terms, const std::vector<Laplace::RationalFunction>& transforms) {
+        ++generation_;
+        content_ = terms.empty() ? nullptr : std::make_shared<const PlotContent>(terms, transforms);
+        waiting_[0] = waiting_[1] = false;
+        bode.clear();
+        time.clear();
+    }
+
+    // Returns true when the event was meant for the panel. Releases never are, so a button
+    // pressed elsewhere is released whatever the drag is doing.
+    bool handleEvent(const sf::Event& event) {
+        if (event.type == sf::Event::MouseWheelScrolled) {
+            Plot* plot = plotAt(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+            if (!plot) return false;
+            plot->zoom(static_cast<float>(event.mouseWheelScroll.x), std::pow(0.8, event.mouseWheelScroll.delta));
+            return true;
+        }
+        if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+            dragging_ = plotAt(event.mouseButton.x, event.mouseButton.y);
+            dragX_ = event.mouseButton.x;
+            return dragging_ != nullptr;
+        }
+        if (event.type == sf::Event::MouseMoved && dragging_) {
+            dragging_->pan(static_cast<float>(event.mouseMove.x - dragX_));
+            dragX_ = event.mouseMove.x;
+            return true;
+        }
+        if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
+            dragging_ = nullptr;
+        }
+        return false;
+    }
+
+    // Once per frame: picks up finished samples and asks for new ones where the view moved.
+    // Returns true when new samples arrived, so the panel has to be drawn again.
+    bool update() {
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int p = 0; p < 2; ++p) {
+                if (ready_[p] && ready_[p]->generation == generation_) {
+                    Plot& target = plot(p);
+                    target.setSamples(*ready_[p]);
+                    if (ready_[p]->from == target.requestedFrom && ready_[p]->to == target.requestedTo) {
+                        waiting_[p] = false; // Not an older request the newest one superseded
+                    }
+                    changed = true;
+                }
+                ready_[p].reset();
+            }
+        }
+
+        if (!content_) return changed;
+        for (int p = 0; p < 2; ++p) {
+            Plot& target = plot(p);
+            if (!target.needsSamples()) continue;
+
+            // One view width of margin on each side, so a pan shows data before the resample lands
+            double span = target.xMax - target.xMin;
+            PlotRequest request{content_, generation_, target.xMin - span, target.xMax + span,
+                                static_cast<size_t>(target.area.width) * 6};
+            if (p == 1 && content_->maxOmega > 0) {
+                // At least 16 samples per period of the fastest oscillation, so it is not aliased
+                double periods = (request.to - request.from) * content_->maxOmega / (2 * M_PI);
+                request.samples = std::max(request.samples, static_cast<size_t>(std::min(periods * 16, 262144.0)));
+            }
+            target.requestedFrom = request.from;
+            target.requestedTo = request.to;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_[p] = std::move(request); // Newest request wins
+            }
+            waiting_[p] = true;
+            wake_.notify_one();
+        }
+        return changed;
+    }
+
+    // Samples have been asked for and not delivered yet.
+    bool busy() const {
+        return waiting_[0] || waiting_[1];
+    }
+
+    void draw(sf::RenderWindow& window) {
+        bode.draw(window);
+        time.draw(window);
+    }
+
+private:
+    Plot bode;
+    Plot time;
+
+    std::shared_ptr<const PlotContent> content_;
+    unsigned generation_ = 0;
+    Plot* dragging_ = nullptr;
+    int dragX_ = 0;
+    bool waiting_[2] = {false, false}; // A request is out for that plot
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::optional<PlotRequest> pending_[2];
+    std::optional<PlotSamples> ready_[2];
+    bool stop_ = false;
+    std::thread worker_; // Last, so everything it touches exists before it starts
+
+    Plot& plot(int p) {
+        return p == 0 ? bode : time;
+    }
+
+    Plot* plotAt(int x, int y) {
+        if (bode.contains(static_cast<float>(x), static_cast<float>(y))) return &bode;
+        if (time.contains(static_cast<float>(x), static_cast<float>(y))) return &time;
+        return nullptr;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this] { return stop_ || pending_[0] || pending_[1]; });
+            if (stop_) return;
+            int p = pending_[0] ? 0 : 1;
+            PlotRequest request = std::move(*pending_[p]);
+            pending_[p].reset();
+
+            lock.unlock();
+            PlotSamples samples = p == 0 ? sampleBode(request) : sampleTime(request);
+            lock.lock();
+            ready_[p] = std::move(samples);
+        }
+    }
+
+    static PlotSamples makeSamples(const PlotRequest& request, size_t curves) {
+        size_t n = std::max<size_t>(request.samples, 2);
+        PlotSamples samples{request.generation, request.from, request.to, std::vector<double>(n),
+                            std::vector<std::vector<double>>(curves, std::vector<double>(n))};
+        for (size_t i = 0; i < n; ++i) {
+            samples.x[i] = request.from + (request.to - request.from) * static_cast<double>(i) / static_cast<double>(n - 1);
+        }
+        return samples;
+    }
+
+    // x is log10(w): magnitude in dB and unwrapped phase in degrees of F(jw).
+    static PlotSamples sampleBode(const PlotRequest& request) {
+        PlotSamples samples = makeSamples(request, 2);
+        size_t n = samples.x.size();
+        std::vector<double> s_re(n, 0.0), s_im(n), re(n), im(n);
+        for (size_t i = 0; i < n; ++i) {
+            s_im[i] = std::pow(10.0, samples.x[i]);
+        }
+        request.content->evaluator.evaluate(s_re.data(), s_im.data(), n, re.data(), im.data());
+
+        double previous = NAN, unwrap = 0;
+        for (size_t i = 0; i < n; ++i) {
+            samples.y[0][i] = 20 * std::log10(std::hypot(re[i], im[i]));
+            double phase = std::atan2(im[i], re[i]) * 180 / M_PI;
+            if (std::isfinite(previous)) {
+                while (phase + unwrap - previous > 180) unwrap -= 360;
+                while (phase + unwrap - previous < -180) unwrap += 360;
+            }
+            samples.y[1][i] = phase + unwrap;
+            if (std::isfinite(im[i])) previous = samples.y[1][i];
+        }
+        return samples;
+    }
+
+    // f(t) straight from the parsed terms; zero before t = 0, as the transform assumes.
+    static PlotSamples sampleTime(const PlotRequest& request) {
+        PlotSamples samples = makeSamples(request, 1);
+        for (size_t i = 0; i < samples.x.size(); ++i) {
+            double t = samples.x[i], value = 0;
+            if (t >= 0) {
+                for (const ParsedTerm& term : request.content->terms) {
+                    value += Laplace::evaluate_term(term, t);
+                }
+            }
+            samples.y[0][i] = value;
+        }
+        return samples;
+    }
+};
@@ -1,6 +1,41 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <algorithm>
 #include <iostream>
+#include "hit_grid.h"
+
+// Set whenever something on screen changes; the main loop only draws a frame while it is set.
+class DirtyFlag {
+    private :
+        bool _dirty = true; // Nothing has been drawn yet
+
+    public :
+
+    void mark() {
+        _dirty = true;
+    }
+
+    bool isSet() const {
+        return _dirty;
+    }
+
+    void clear() {
+        _dirty = false;
+    }
+};
+
+// Waits for the next event for at most `timeout`. SFML 2 can block on events but not with
+// a timeout, so this sleeps between polls: the thread stays idle, and input still arrives
+// within a few milliseconds.
+inline bool waitEvent(sf::Window& window, sf::Event& event, sf::Time timeout) {
+    sf::Clock waited;
+    for (;;) {
+        if (window.pollEvent(event)) return true;
+        sf::Time left = timeout - waited.getElapsedTime();
+        if (left <= sf::Time::Zero) return false;
+        sf::sleep(std::min(left, sf::milliseconds(10)));
+    }
+}
 
 class Button {
 
@@ -9,6 +44,7 @@ class Button {
     sf::RectangleShape shape;
     sf::Text text;
     bool isPressed = false;
+    DirtyFlag* dirty = nullptr; // Marked when the button moves on press and release
 
 
     Button(const sf::Vector2f& size, const sf::Font& font, const std::wstring& label   ) {
@@ -44,12 +80,14 @@ class Button {
     void press() {
         shape.move(2, 2);
         isPressed = true;
+        if (dirty) dirty->mark();
     }
 
     void release() {
         if (isPressed) {
             shape.move(-2, -2);
             isPressed = false;
+            if (dirty) dirty->mark();
         }
     }
 };
@@ -82,6 +120,102 @@ class Cursor : public sf::RectangleShape {
 };
 
 
+// Every button in two draw calls: one triangle list with all outlines and fills, and one
+// with all labels, textured from the font's glyph atlas. Labels are laid out once in
+// build(); only the shape vertices are rewritten per frame, since presses move the shapes.
+// Lookups under the mouse go through a HitGrid built from the resting positions.
+class ButtonBatch {
+    private :
+        sf::VertexArray _shapes{sf::Triangles};  // 12 vertices per button: outline, then fill
+        sf::VertexArray _labels{sf::Triangles};  // 6 vertices per visible glyph
+        const sf::Font* _font = nullptr;
+        unsigned _characterSize = 0;
+        Laplace::HitGrid _grid;
+
+        static void setQuad(sf::Vertex* quad, const sf::FloatRect& rect, sf::Color color, const sf::FloatRect& texture = sf::FloatRect()) {
+            float right = rect.left + rect.width, bottom = rect.top + rect.height;
+            float u2 = texture.left + texture.width, v2 = texture.top + texture.height;
+            quad[0] = sf::Vertex({rect.left, rect.top}, color, {texture.left, texture.top});
+            quad[1] = sf::Vertex({right, rect.top}, color, {u2, texture.top});
+            quad[2] = sf::Vertex({rect.left, bottom}, color, {texture.left, v2});
+            quad[3] = quad[2];
+            quad[4] = quad[1];
+            quad[5] = sf::Vertex({right, bottom}, color, {u2, v2});
+        }
+
+        void setShape(size_t i, const sf::RectangleShape& shape) {
+            sf::Vector2f position = shape.getPosition();
+            sf::Vector2f size = shape.getSize();
+            float outline = shape.getOutlineThickness();
+            setQuad(&_shapes[12 * i], sf::FloatRect(position.x - outline, position.y - outline, size.x + 2 * outline, size.y + 2 * outline), shape.getOutlineColor());
+            setQuad(&_shapes[12 * i + 6], sf::FloatRect(position.x, position.y, size.x, size.y), shape.getFillColor());
+        }
+
+        // Same glyph placement as sf::Text: baseline one character size down, kerning
+        // between pairs, one pixel of padding around each glyph's texture rectangle.
+        void appendLabel(const sf::Text& text) {
+            std::wstring label = text.getString();
+            sf::Vector2f origin = text.getPosition();
+            sf::Color color = text.getFillColor();
+            float whitespace = _font->getGlyph(L' ', _characterSize, false).advance;
+            float x = 0, y = static_cast<float>(_characterSize);
+            sf::Uint32 previous = 0;
+
+            for (wchar_t c : label) {
+                sf::Uint32 current = static_cast<sf::Uint32>(c);
+                x += _font->getKerning(previous, current, _characterSize);
+                previous = current;
+                if (c == L' ' || c == L'\t') {
+                    x += c == L' ' ? whitespace : 4 * whitespace;
+                    continue;
+                }
+
+                const sf::Glyph& glyph = _font->getGlyph(current, _characterSize, false);
+                sf::FloatRect bounds(origin.x + x + glyph.bounds.left - 1, origin.y + y + glyph.bounds.top - 1, glyph.bounds.width + 2, glyph.bounds.height + 2);
+                sf::FloatRect texture(glyph.textureRect.left - 1.f, glyph.textureRect.top - 1.f, glyph.textureRect.width + 2.f, glyph.textureRect.height + 2.f);
+                size_t first = _labels.getVertexCount();
+                _labels.resize(first + 6);
+                setQuad(&_labels[first], bounds, color, texture);
+                x += glyph.advance;
+            }
+        }
+
+    public :
+
+    void build(const std::vector<Button>& buttons) {
+        _shapes.resize(12 * buttons.size());
+        _labels.clear();
+        _font = buttons.empty() ? nullptr : buttons[0].text.getFont();
+        _characterSize = buttons.empty() ? 0 : buttons[0].text.getCharacterSize();
+
+        std::vector<Laplace::HitRect> rects;
+        for (size_t i = 0; i < buttons.size(); ++i) {
+            setShape(i, buttons[i].shape);
+            appendLabel(buttons[i].text);
+            sf::FloatRect bounds = buttons[i].shape.getGlobalBounds();
+            rects.push_back({bounds.left, bounds.top, bounds.width, bounds.height});
+        }
+        _grid = Laplace::HitGrid(rects);
+    }
+
+    // Index of the button under point, or HitGrid::npos.
+    int find(const sf::Vector2f& point) const {
+        return _grid.find(point.x, point.y);
+    }
+
+    void draw(sf::RenderWindow& window, const std::vector<Button>& buttons) {
+        for (size_t i = 0; i < buttons.size() && 12 * i < _shapes.getVertexCount(); ++i)
+            setShape(i, buttons[i].shape); // Pressed buttons sit 2px down and right
+
+        window.draw(_shapes);
+        if (_font) {
+            sf::RenderStates states;
+            states.texture = &_font->getTexture(_characterSize); // Fetched per draw: the atlas grows as glyphs are added
+            window.draw(_labels, states);
+        }
+    }
+};
+
 class UI {
 private:
 
@@ -97,6 +231,7 @@ private:
 
     for (int i = 0; i < labels.size(); ++i) {
         Button button({btnWidth, btnHeight}, font, labels[i]);
+        button.dirty = &dirty;
         float x = startX + (i % buttonsPerRow) * (btnWidth + 10);
         float y = startY + (i / buttonsPerRow) * (btnHeight + 10);
         button.setPosition(x, y);
@@ -135,6 +270,7 @@ private:
 
         // Create and position the button
         Button button({btnWidth, btnHeight}, font, label);
+        button.dirty = &dirty;
         float x = startX + col * (btnWidth + 10);
         float y = startY + row * (btnHeight + 10);
         button.setPosition(x, y);
@@ -163,9 +299,16 @@ private:
 
 public:
 
+    // Redraw flag shared with every button setup() makes.
+    DirtyFlag dirty;
+
+    // Draws and hit-tests the buttons setup() makes.
+    ButtonBatch batch;
+
     void setup(std::vector<std::wstring> &labels , std::vector<Button> &buttons , sf::Font &font , sf::RectangleShape &inputBox , sf::Text &inputText ) {
 
     setupLabels(labels , buttons , font) ;
+    batch.build(buttons) ;
 
     //Setting the white box and the string written inside it
 
@@ -0,0 +1,66 @@
+#ifndef BIG_INT_H
+#define BIG_INT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Laplace {
+
+// Arbitrary precision signed integer, for the exact coefficients that outgrow 64 bits
+// (200!, or a sum of fractions with large coprime denominators). Sign and magnitude, the
+// magnitude in 32-bit limbs, least significant first, with no leading zero limbs, so zero
+// has no limbs. Division truncates toward zero like the built-in integers.
+class BigInt {
+public:
+    BigInt() = default;
+    BigInt(int64_t value);
+
+    // 2^k
+    static BigInt power_of_two(unsigned k);
+
+    bool is_zero() const { return limbs_.empty(); }
+    int sign() const { return is_zero() ? 0 : (negative_ ? -1 : 1); }
+    bool fits_int64() const; // Excludes INT64_MIN, so the value can always be negated
+    int64_t to_int64() const; // Only when fits_int64()
+
+    // Nearest double, with the exponent kept apart so values past double range still
+    // work: value = mantissa * 2^exponent, 0.5 <= |mantissa| < 1 (0 for zero).
+    double to_double() const;
+    double frexp(long& exponent) const;
+
+    BigInt operator-() const;
+    BigInt abs() const;
+
+    friend BigInt operator+(const BigInt& a, const BigInt& b);
+    friend BigInt operator-(const BigInt& a, const BigInt& b);
+    friend BigInt operator*(const BigInt& a, const BigInt& b);
+
+    // Quotient and remainder in one pass. Throws std::domain_error when b is zero.
+    static void divide(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder);
+    friend BigInt operator/(const BigInt& a, const BigInt& b);
+    friend BigInt operator%(const BigInt& a, const BigInt& b);
+
+    static BigInt gcd(BigInt a, BigInt b); // Non-negative; gcd(0, 0) = 0
+
+    // -1, 0 or 1
+    static int compare(const BigInt& a, const BigInt& b);
+    friend bool operator==(const BigInt& a, const BigInt& b) { return compare(a, b) == 0; }
+    friend bool operator!=(const BigInt& a, const BigInt& b) { return compare(a, b) != 0; }
+    friend bool operator<(const BigInt& a, const BigInt& b) { return compare(a, b) < 0; }
+
+    void append_to(std::string& out) const; // Decimal
+    std::string to_string() const;
+
+private:
+    using Limbs = std::vector<uint32_t>;
+
+    bool negative_ = false;
+    Limbs limbs_;
+
+    static BigInt from_magnitude(Limbs limbs, bool negative);
+};
+
+} // namespace Laplace
+
+#endif // BIG_INT_H
@@ -0,0 +1,22 @@
+#ifndef CANONICAL_FORM_H
+#define CANONICAL_FORM_H
+
+#include <string>
+#include <vector>
+#include "parser.h"
+
+namespace Laplace {
+
+// Canonical form of a parsed expression, packed into a string so it can key a hash map.
+// Terms are sorted by family, then parameters, then coefficient, and -0.0 is folded into
+// 0.0, so inputs that differ only in spacing, term order or spelling (e^(2*t) vs exp(2*t))
+// map to the same key. The encoding is exact: decode_canonical_key gives the terms back.
+// Throws std::domain_error if a coefficient or parameter is infinite or NaN.
+std::string canonical_key(const std::vector<ParsedTerm>& terms);
+
+// Terms of a key made by canonical_key, in canonical order (original_term_str is empty).
+std::vector<ParsedTerm> decode_canonical_key(const std::string& key);
+
+} // namespace Laplace
+
+#endif // CANONICAL_FORM_H
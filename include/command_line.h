@@ -0,0 +1,46 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <cerrno>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace Laplace {
+
+// Numeric command-line arguments. Unlike std::stoul and std::stod these take the whole
+// argument or nothing, so "-j abc", "-j 4x" and "-j -1" are rejected rather than throwing,
+// stopping early or wrapping around; the caller prints its usage.
+
+// A whole number in [0, max], digits only.
+inline bool parse_count_argument(const char* text, unsigned long long max, unsigned long long& value) {
+    if (!std::isdigit(static_cast<unsigned char>(text[0]))) return false;
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > max) return false;
+    value = parsed;
+    return true;
+}
+
+template <typename Count>
+bool parse_count_argument(const char* text, Count& value) {
+    unsigned long long parsed = 0;
+    if (!parse_count_argument(text, static_cast<unsigned long long>(std::numeric_limits<Count>::max()), parsed)) return false;
+    value = static_cast<Count>(parsed);
+    return true;
+}
+
+// A finite real number.
+inline bool parse_real_argument(const char* text, double& value) {
+    char* end = nullptr;
+    double parsed = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !std::isfinite(parsed)) return false;
+    value = parsed;
+    return true;
+}
+
+} // namespace Laplace
+
+#endif // COMMAND_LINE_H
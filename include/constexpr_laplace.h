@@ -0,0 +1,599 @@
+#ifndef CONSTEXPR_LAPLACE_H
+#define CONSTEXPR_LAPLACE_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept> // For exceptions
+#include <string_view>
+#include <vector>
+#include "parser.h"             // TokenType, FunctionType
+#include "rational_function.h"
+#include "special_functions.h" // Factorial table
+
+// Compile-time tokenizer, parser and transform table.
+//
+//   constexpr auto H = Laplace::ct::laplace("3*exp(-2*t)*sin(5*t)");
+//
+// yields the same coefficients as Laplace::transform_*, with no parsing left for run time.
+// A literal outside the grammar below hits a throw during constant evaluation, which fails
+// the build and points at the message.
+//
+// The grammar is a subset of Parser's, the flat sums the original table covered:
+//   expression := [+|-] product {(+|-) product}
+//   product    := factor {'*' factor}                  -- no '/'
+//   factor     := number | PI | t | t^number | name(argument) | e^(argument) | '(' [+|-] product ')'
+//   argument   := [+|-] atom [['*'] atom], atom := number | PI | t  -- no offset: sin(2t), not sin(2t + 1)
+// A product holds at most one exp and one of sin/cos/sinh/cosh; t^n goes with exp alone for
+// any whole n, and with sin/cos/sinh/cosh only for n = 1. Parser also takes nested sums,
+// quotients, powers of sums, e^-t, offsets in arguments and real powers of t next to other
+// factors; those need the run-time path. So does t^n past n = 170, whose n! overflows a
+// double: it and any other coefficient that is not finite throw rather than yield +inf.
+namespace Laplace {
+namespace ct {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Same layout as RationalFunction (gain * N(u) / D(u)^power, u = s - shift), in fixed arrays.
+struct StaticRational {
+    double gain = 0.0;
+    double numerator[3] = {};
+    size_t numerator_size = 0;
+    double denominator[3] = {};
+    size_t denominator_size = 0;
+    int power = 1;
+    double shift = 0.0;
+
+    constexpr bool is_zero() const { return gain == 0.0; }
+
+    // F(s) for real s
+    constexpr double evaluate(double s) const {
+        if (is_zero()) return 0.0;
+        double u = s - shift;
+        double n = 0.0, d = 0.0;
+        for (size_t k = numerator_size; k-- > 0;) n = n * u + numerator[k];
+        for (size_t k = denominator_size; k-- > 0;) d = d * u + denominator[k];
+        double d_power = 1.0;
+        for (int i = 0; i < power; ++i) d_power *= d;
+        return gain * n / d_power;
+    }
+
+    RationalFunction to_runtime() const {
+        if (is_zero()) return {};
+        return {gain,
+                std::vector<double>(numerator, numerator + numerator_size),
+                std::vector<double>(denominator, denominator + denominator_size),
+                power, shift};
+    }
+};
+
+// Transform of a whole expression: one StaticRational per additive term.
+template <size_t MaxTerms>
+struct StaticExpression {
+    StaticRational terms[MaxTerms] = {};
+    size_t size = 0;
+
+    constexpr double evaluate(double s) const {
+        double total = 0.0;
+        for (size_t i = 0; i < size; ++i) total += terms[i].evaluate(s);
+        return total;
+    }
+
+    std::vector<RationalFunction> to_runtime() const {
+        std::vector<RationalFunction> result;
+        result.reserve(size);
+        for (size_t i = 0; i < size; ++i) result.push_back(terms[i].to_runtime());
+        return result;
+    }
+};
+
+// --- Coefficient math, shared with the run-time table in laplace_transforms.cpp ---
+
+// Correctly rounded table entry; +infinity past 170!, which the fixed arrays here cannot
+// carry in log form, so the transforms below throw there instead.
+constexpr double factorial(int n) {
+    return Laplace::factorial(n);
+}
+
+// Builds gain * (n0 + n1*u + n2*u^2) / (d0 + d1*u + d2*u^2)^power with u = s - shift.
+constexpr StaticRational make_rational(double gain, std::initializer_list<double> numerator,
+                                       std::initializer_list<double> denominator, int power = 1, double shift = 0.0) {
+    StaticRational r;
+    r.gain = gain;
+    for (double c : numerator) r.numerator[r.numerator_size++] = c;
+    for (double c : denominator) r.denominator[r.denominator_size++] = c;
+    r.power = power;
+    r.shift = shift;
+    return r;
+}
+
+constexpr StaticRational transform_constant(double c) {
+    return make_rational(c, {1.0}, {0.0, 1.0});
+}
+
+constexpr StaticRational transform_t_pow_n(int n, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    if (n < 0) throw std::invalid_argument("n must be a non-negative integer for L{t^n}.");
+    if (n > kMaxFactorial) throw std::overflow_error("n! overflows past n = 170; L{t^n} needs the run-time table.");
+    return make_rational(coeff * factorial(n), {1.0}, {0.0, 1.0}, n + 1);
+}
+
+constexpr StaticRational transform_t_n_exp(int n, double a, double coeff = 1.0) {
+    StaticRational r = transform_t_pow_n(n, coeff);
+    r.shift = a;
+    return r;
+}
+
+constexpr StaticRational transform_exp(double a, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    return make_rational(coeff, {1.0}, {0.0, 1.0}, 1, a);
+}
+
+constexpr StaticRational transform_sin(double omega, double coeff = 1.0) {
+    if (coeff == 0.0 || omega == 0.0) return {};
+    return make_rational(coeff, {omega}, {omega * omega, 0.0, 1.0});
+}
+
+constexpr StaticRational transform_cos(double omega, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    if (omega == 0.0) return transform_constant(coeff);
+    return make_rational(coeff, {0.0, 1.0}, {omega * omega, 0.0, 1.0});
+}
+
+constexpr StaticRational transform_t_exp(double a, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    return make_rational(coeff, {1.0}, {0.0, 1.0}, 2, a);
+}
+
+constexpr StaticRational transform_t_sin(double omega, double coeff = 1.0) {
+    if (coeff == 0.0 || omega == 0.0) return {};
+    return make_rational(coeff, {0.0, 2.0 * omega}, {omega * omega, 0.0, 1.0}, 2);
+}
+
+constexpr StaticRational transform_t_cos(double omega, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    if (omega == 0.0) return transform_t_pow_n(1, coeff);
+    return make_rational(coeff, {-omega * omega, 0.0, 1.0}, {omega * omega, 0.0, 1.0}, 2);
+}
+
+constexpr StaticRational transform_exp_sin(double a, double omega, double coeff = 1.0) {
+    if (coeff == 0.0 || omega == 0.0) return {};
+    return make_rational(coeff, {omega}, {omega * omega, 0.0, 1.0}, 1, a);
+}
+
+constexpr StaticRational transform_exp_cos(double a, double omega, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    if (omega == 0.0) return transform_exp(a, coeff);
+    return make_rational(coeff, {0.0, 1.0}, {omega * omega, 0.0, 1.0}, 1, a);
+}
+
+constexpr StaticRational transform_sinh(double omega, double coeff = 1.0) {
+    if (coeff == 0.0 || omega == 0.0) return {};
+    return make_rational(coeff, {omega}, {-omega * omega, 0.0, 1.0});
+}
+
+constexpr StaticRational transform_cosh(double omega, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    if (omega == 0.0) return transform_constant(coeff);
+    return make_rational(coeff, {0.0, 1.0}, {-omega * omega, 0.0, 1.0});
+}
+
+constexpr StaticRational transform_t_sinh(double omega, double coeff = 1.0) {
+    if (coeff == 0.0 || omega == 0.0) return {};
+    return make_rational(coeff, {0.0, 2.0 * omega}, {-omega * omega, 0.0, 1.0}, 2);
+}
+
+constexpr StaticRational transform_t_cosh(double omega, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    if (omega == 0.0) return transform_t_pow_n(1, coeff);
+    return make_rational(coeff, {omega * omega, 0.0, 1.0}, {-omega * omega, 0.0, 1.0}, 2);
+}
+
+constexpr StaticRational transform_exp_sinh(double a, double omega, double coeff = 1.0) {
+    if (coeff == 0.0 || omega == 0.0) return {};
+    return make_rational(coeff, {omega}, {-omega * omega, 0.0, 1.0}, 1, a);
+}
+
+constexpr StaticRational transform_exp_cosh(double a, double omega, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    if (omega == 0.0) return transform_exp(a, coeff);
+    return make_rational(coeff, {0.0, 1.0}, {-omega * omega, 0.0, 1.0}, 1, a);
+}
+
+constexpr StaticRational transform_t_exp_sin(double a, double omega, double coeff = 1.0) {
+    if (coeff == 0.0 || omega == 0.0) return {};
+    return make_rational(coeff, {0.0, 2.0 * omega}, {omega * omega, 0.0, 1.0}, 2, a);
+}
+
+constexpr StaticRational transform_t_exp_cos(double a, double omega, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    if (omega == 0.0) return transform_t_exp(a, coeff);
+    return make_rational(coeff, {-omega * omega, 0.0, 1.0}, {omega * omega, 0.0, 1.0}, 2, a);
+}
+
+constexpr StaticRational transform_t_exp_sinh(double a, double omega, double coeff = 1.0) {
+    if (coeff == 0.0 || omega == 0.0) return {};
+    return make_rational(coeff, {0.0, 2.0 * omega}, {-omega * omega, 0.0, 1.0}, 2, a);
+}
+
+constexpr StaticRational transform_t_exp_cosh(double a, double omega, double coeff = 1.0) {
+    if (coeff == 0.0) return {};
+    if (omega == 0.0) return transform_t_exp(a, coeff);
+    return make_rational(coeff, {omega * omega, 0.0, 1.0}, {-omega * omega, 0.0, 1.0}, 2, a);
+}
+
+namespace detail {
+
+constexpr size_t kMaxTokens = 256;
+
+struct Token {
+    TokenType type = TokenType::END_OF_INPUT;
+    std::string_view text;
+    double value = 0.0;
+};
+
+struct Term {
+    double coefficient = 1.0;
+    FunctionType type = FunctionType::UNRECOGNIZED;
+    double parameters[3] = {};
+    size_t parameter_count = 0;
+};
+
+constexpr bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+constexpr bool is_digit(char c) { return c >= '0' && c <= '9'; }
+constexpr bool is_alpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+// False for infinities and NaN; std::isfinite is not constexpr
+constexpr bool is_finite(double x) { return x - x == 0.0; }
+
+// Decimal literal without exponent. Digits are accumulated as an integer and divided by a
+// power of ten once, which is correctly rounded for the literals people actually write.
+constexpr double parse_number(std::string_view text) {
+    double mantissa = 0.0;
+    double scale = 1.0;
+    bool decimal_found = false;
+    for (char c : text) {
+        if (c == '.') {
+            decimal_found = true;
+            continue;
+        }
+        mantissa = mantissa * 10.0 + (c - '0');
+        if (decimal_found) scale *= 10.0;
+    }
+    return mantissa / scale;
+}
+
+constexpr FunctionType fold_oscillation(FunctionType trig, int t_power, bool has_exp) {
+    if (t_power == 0 && !has_exp) return trig;
+    if (t_power == 0) {
+        switch (trig) {
+            case FunctionType::SIN: return FunctionType::EXP_SIN;
+            case FunctionType::COS: return FunctionType::EXP_COS;
+            case FunctionType::SINH: return FunctionType::EXP_SINH;
+            default: return FunctionType::EXP_COSH;
+        }
+    }
+    if (!has_exp) {
+        switch (trig) {
+            case FunctionType::SIN: return FunctionType::T_SIN;
+            case FunctionType::COS: return FunctionType::T_COS;
+            case FunctionType::SINH: return FunctionType::T_SINH;
+            default: return FunctionType::T_COSH;
+        }
+    }
+    switch (trig) {
+        case FunctionType::SIN: return FunctionType::T_EXP_SIN;
+        case FunctionType::COS: return FunctionType::T_EXP_COS;
+        case FunctionType::SINH: return FunctionType::T_EXP_SINH;
+        default: return FunctionType::T_EXP_COSH;
+    }
+}
+
+// Parser's flat-sum subset (see the top of this file) for constant evaluation: fixed token
+// storage, no allocation.
+class Parser {
+public:
+    constexpr explicit Parser(std::string_view input) { tokenize(input); }
+
+    template <size_t MaxTerms>
+    constexpr size_t parse(Term (&terms)[MaxTerms]) {
+        size_t count = 0;
+        if (current().type == TokenType::END_OF_INPUT) return 0;
+        double sign = leading_sign();
+        do {
+            if (count == MaxTerms) throw std::length_error("Too many terms for the StaticExpression capacity.");
+            terms[count] = parse_multiplication();
+            terms[count].coefficient *= sign;
+            ++count;
+            if (current().type != TokenType::PLUS && current().type != TokenType::MINUS) break;
+            sign = current().type == TokenType::PLUS ? 1.0 : -1.0;
+            consume();
+        } while (true);
+        if (current().type != TokenType::END_OF_INPUT) throw std::invalid_argument("Unexpected token at end of expression.");
+        return count;
+    }
+
+private:
+    Token tokens_[kMaxTokens] = {};
+    size_t count_ = 0;
+    size_t index_ = 0;
+
+    constexpr void push(TokenType type, std::string_view text, double value = 0.0) {
+        if (count_ == kMaxTokens) throw std::length_error("Expression too long for compile-time parsing.");
+        tokens_[count_].type = type;
+        tokens_[count_].text = text;
+        tokens_[count_].value = value;
+        ++count_;
+    }
+
+    constexpr void tokenize(std::string_view input) {
+        size_t pos = 0;
+        while (pos < input.size()) {
+            char c = input[pos];
+            if (is_space(c)) {
+                ++pos;
+                continue;
+            }
+            if (is_digit(c) || (c == '.' && pos + 1 < input.size() && is_digit(input[pos + 1]))) {
+                size_t start = pos;
+                bool decimal_found = false;
+                while (pos < input.size() && (is_digit(input[pos]) || input[pos] == '.')) {
+                    if (input[pos] == '.') {
+                        if (decimal_found) throw std::invalid_argument("Multiple decimal points in number.");
+                        decimal_found = true;
+                    }
+                    ++pos;
+                }
+                std::string_view text = input.substr(start, pos - start);
+                push(TokenType::NUMBER, text, parse_number(text));
+                continue;
+            }
+            if (is_alpha(c)) {
+                size_t start = pos++;
+                while (pos < input.size() && (is_alpha(input[pos]) || is_digit(input[pos]))) ++pos;
+                push(TokenType::IDENTIFIER, input.substr(start, pos - start));
+                continue;
+            }
+            TokenType type = TokenType::UNKNOWN;
+            switch (c) {
+                case '+': type = TokenType::PLUS; break;
+                case '-': type = TokenType::MINUS; break;
+                case '*': type = TokenType::MULTIPLY; break;
+                case '/': type = TokenType::DIVIDE; break;
+                case '^': type = TokenType::POWER; break;
+                case '(': type = TokenType::LPAREN; break;
+                case ')': type = TokenType::RPAREN; break;
+                default: throw std::invalid_argument("Unknown character in input.");
+            }
+            push(type, input.substr(pos, 1));
+            ++pos;
+        }
+        push(TokenType::END_OF_INPUT, std::string_view());
+    }
+
+    constexpr const Token& current() const { return tokens_[index_]; }
+    constexpr void consume() {
+        if (index_ + 1 < count_) ++index_;
+    }
+    constexpr void expect(TokenType type, const char* message) {
+        if (current().type != type) throw std::invalid_argument(message);
+        consume();
+    }
+
+    constexpr double leading_sign() {
+        if (current().type == TokenType::MINUS) {
+            consume();
+            return -1.0;
+        }
+        if (current().type == TokenType::PLUS) consume();
+        return 1.0;
+    }
+
+    // [+|-] number | PI | t  [ ['*'] number | PI | t ]; a lone constant c means c*t, as in
+    // Parser, which also lets PI or t follow without the '*': 3t, 2PI
+    constexpr double argument_value() {
+        double sign = leading_sign();
+        double val = 1.0;
+        bool t_seen = false;
+        for (int part = 0; part < 2; ++part) {
+            if (current().type == TokenType::NUMBER) {
+                val *= current().value;
+            } else if (current().text == "PI") {
+                val *= kPi;
+            } else if (current().text == "t" && !t_seen) {
+                t_seen = true;
+            } else {
+                throw std::invalid_argument("Invalid function argument. Expected number, PI, or 't'.");
+            }
+            consume();
+            if (part == 1) break;
+            if (current().type == TokenType::MULTIPLY) consume();
+            else if (current().type != TokenType::IDENTIFIER) break;
+        }
+        return val * sign;
+    }
+
+    constexpr Term parse_factor() {
+        Term term;
+        const Token& token = current();
+        if (token.type == TokenType::NUMBER || token.text == "PI") {
+            term.type = FunctionType::CONSTANT;
+            term.coefficient = token.type == TokenType::NUMBER ? token.value : kPi;
+            consume();
+            return term;
+        }
+        if (token.text == "t") {
+            consume();
+            term.type = FunctionType::T_POW_N;
+            term.parameters[0] = 1.0;
+            term.parameter_count = 1;
+            if (current().type == TokenType::POWER) {
+                consume();
+                if (current().type != TokenType::NUMBER) throw std::invalid_argument("Expected number for exponent after 't^'.");
+                term.parameters[0] = current().value;
+                consume();
+            }
+            return term;
+        }
+        if (token.type == TokenType::IDENTIFIER) {
+            std::string_view name = token.text;
+            consume();
+            if (name == "e") expect(TokenType::POWER, "Identifier 'e' must be followed by '^'.");
+            expect(TokenType::LPAREN, "Expected '(' after function name.");
+            term.parameters[0] = argument_value();
+            term.parameter_count = 1;
+            expect(TokenType::RPAREN, "Expected ')' after function arguments.");
+            if (name == "sin") term.type = FunctionType::SIN;
+            else if (name == "cos") term.type = FunctionType::COS;
+            else if (name == "exp" || name == "e") term.type = FunctionType::EXP;
+            else if (name == "sinh") term.type = FunctionType::SINH;
+            else if (name == "cosh") term.type = FunctionType::COSH;
+            else throw std::invalid_argument("Unrecognized function name.");
+            return term;
+        }
+        if (token.type == TokenType::LPAREN) {
+            consume();
+            double sign = leading_sign();
+            term = parse_multiplication();
+            term.coefficient *= sign;
+            if (current().type == TokenType::PLUS || current().type == TokenType::MINUS) {
+                throw std::invalid_argument("Parenthesized expressions currently only support a single combined term.");
+            }
+            expect(TokenType::RPAREN, "Expected ')' after parenthesized expression.");
+            return term;
+        }
+        throw std::invalid_argument("Unexpected token while parsing factor.");
+    }
+
+    // Folds a product into one family with the same rules as the transform registry.
+    constexpr Term parse_multiplication() {
+        Term first = parse_factor();
+        if (current().type != TokenType::MULTIPLY) return first;
+
+        Term combined;
+        double t_exponent = 0.0;
+        bool has_t = false, has_exp = false;
+        double exp_a = 0.0, omega = 0.0;
+        FunctionType trig = FunctionType::UNRECOGNIZED;
+
+        Term factor = first;
+        for (;;) {
+            combined.coefficient *= factor.coefficient;
+            switch (factor.type) {
+                case FunctionType::CONSTANT:
+                    break;
+                case FunctionType::T_POW_N:
+                    has_t = true;
+                    t_exponent += factor.parameters[0];
+                    break;
+                case FunctionType::EXP:
+                    if (has_exp) throw std::invalid_argument("Multiple exponential functions in multiplication are not supported.");
+                    has_exp = true;
+                    exp_a = factor.parameters[0];
+                    break;
+                case FunctionType::SIN:
+                case FunctionType::COS:
+                case FunctionType::SINH:
+                case FunctionType::COSH:
+                    if (trig != FunctionType::UNRECOGNIZED) throw std::invalid_argument("Multiple trigonometric/hyperbolic functions in multiplication are not supported.");
+                    trig = factor.type;
+                    omega = factor.parameters[0];
+                    break;
+                default:
+                    throw std::invalid_argument("Unsupported function type in multiplication.");
+            }
+            if (current().type != TokenType::MULTIPLY) break;
+            consume();
+            factor = parse_factor();
+        }
+
+        if (!has_t) t_exponent = 0.0;
+        bool oscillates = trig != FunctionType::UNRECOGNIZED;
+        if (!has_exp && !oscillates) {
+            if (t_exponent == 0.0) {
+                combined.type = FunctionType::CONSTANT;
+            } else {
+                combined.type = FunctionType::T_POW_N;
+                combined.parameters[combined.parameter_count++] = t_exponent;
+            }
+            return combined;
+        }
+        if (!oscillates && t_exponent > 1.0) {
+            combined.type = FunctionType::T_N_EXP;
+            combined.parameters[combined.parameter_count++] = t_exponent;
+            combined.parameters[combined.parameter_count++] = exp_a;
+            return combined;
+        }
+        if (t_exponent != 0.0 && t_exponent != 1.0) {
+            throw std::invalid_argument("Unsupported complex multiplication: t^n (n>1) with sin, cos, sinh or cosh.");
+        }
+        int t_power = static_cast<int>(t_exponent);
+        if (oscillates) combined.type = fold_oscillation(trig, t_power, has_exp);
+        else combined.type = t_power == 1 ? FunctionType::T_EXP : FunctionType::EXP;
+        if (has_exp) combined.parameters[combined.parameter_count++] = exp_a;
+        if (oscillates) combined.parameters[combined.parameter_count++] = omega;
+        return combined;
+    }
+};
+
+// Checked before the cast, which is undefined for doubles out of int range
+constexpr int whole_power(double n) {
+    if (!(n >= 0.0)) throw std::invalid_argument("n must be a non-negative integer for L{t^n}.");
+    if (n > kMaxFactorial) throw std::overflow_error("n! overflows past n = 170; L{t^n} needs the run-time table.");
+    if (n != static_cast<int>(n)) throw std::invalid_argument("Non-integer powers of t need the run-time table.");
+    return static_cast<int>(n);
+}
+
+constexpr StaticRational transform(const Term& term) {
+    const double* p = term.parameters;
+    double c = term.coefficient;
+    switch (term.type) {
+        case FunctionType::CONSTANT: return transform_constant(c);
+        case FunctionType::T_POW_N: return transform_t_pow_n(whole_power(p[0]), c);
+        case FunctionType::SIN: return transform_sin(p[0], c);
+        case FunctionType::COS: return transform_cos(p[0], c);
+        case FunctionType::EXP: return transform_exp(p[0], c);
+        case FunctionType::SINH: return transform_sinh(p[0], c);
+        case FunctionType::COSH: return transform_cosh(p[0], c);
+        case FunctionType::T_EXP: return transform_t_exp(p[0], c);
+        case FunctionType::T_N_EXP: return transform_t_n_exp(whole_power(p[0]), p[1], c);
+        case FunctionType::T_SIN: return transform_t_sin(p[0], c);
+        case FunctionType::T_COS: return transform_t_cos(p[0], c);
+        case FunctionType::EXP_SIN: return transform_exp_sin(p[0], p[1], c);
+        case FunctionType::EXP_COS: return transform_exp_cos(p[0], p[1], c);
+        case FunctionType::T_SINH: return transform_t_sinh(p[0], c);
+        case FunctionType::T_COSH: return transform_t_cosh(p[0], c);
+        case FunctionType::EXP_SINH: return transform_exp_sinh(p[0], p[1], c);
+        case FunctionType::EXP_COSH: return transform_exp_cosh(p[0], p[1], c);
+        case FunctionType::T_EXP_SIN: return transform_t_exp_sin(p[0], p[1], c);
+        case FunctionType::T_EXP_COS: return transform_t_exp_cos(p[0], p[1], c);
+        case FunctionType::T_EXP_SINH: return transform_t_exp_sinh(p[0], p[1], c);
+        case FunctionType::T_EXP_COSH: return transform_t_exp_cosh(p[0], p[1], c);
+        default: throw std::invalid_argument("Unrecognized term.");
+    }
+}
+
+} // namespace detail
+
+// Parses and transforms `expression`; use it to initialise a constexpr variable so that
+// all of the work, and any error, happens at compile time.
+template <size_t MaxTerms = 8>
+constexpr StaticExpression<MaxTerms> laplace(std::string_view expression) {
+    detail::Term terms[MaxTerms] = {};
+    detail::Parser parser(expression);
+    size_t count = parser.parse(terms);
+
+    StaticExpression<MaxTerms> result;
+    for (size_t i = 0; i < count; ++i) {
+        const StaticRational& r = result.terms[i] = detail::transform(terms[i]);
+        bool finite = detail::is_finite(r.gain) && detail::is_finite(r.shift);
+        for (size_t k = 0; k < r.numerator_size; ++k) finite = finite && detail::is_finite(r.numerator[k]);
+        for (size_t k = 0; k < r.denominator_size; ++k) finite = finite && detail::is_finite(r.denominator[k]);
+        if (!finite) throw std::overflow_error("Transform coefficient is not finite.");
+    }
+    result.size = count;
+    return result;
+}
+
+} // namespace ct
+} // namespace Laplace
+
+#endif // CONSTEXPR_LAPLACE_H
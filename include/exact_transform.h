@@ -0,0 +1,48 @@
+#ifndef EXACT_TRANSFORM_H
+#define EXACT_TRANSFORM_H
+
+#include <string>
+#include <vector>
+#include "parser.h"
+#include "rational.h"
+
+namespace Laplace {
+
+// Largest power of t the exact path takes: n! has n log10(n) digits, so past this the
+// answer is more digits than anyone reads.
+constexpr int kMaxExactPower = 10000;
+
+// RationalFunction with exact coefficients: F(s) = gain * N(u) / D(u)^power, u = s - shift,
+// polynomials lowest power first. Only the integer powers of t have one, since Gamma of a
+// fraction is irrational.
+struct ExactRationalFunction {
+    Rational gain;                      // 0 means F(s) = 0
+    std::vector<Rational> numerator;    // N(u)
+    std::vector<Rational> denominator;  // D(u), monic
+    int power = 1;                      // exponent applied to D(u)
+    Rational shift;                     // u = s - shift
+
+    bool is_zero() const;
+
+    // The layout of RationalFunction::append_to, with a fraction that multiplies or divides
+    // in parentheses: "(1/3)/(s^2 + 1/9)", "(3/10)*s/(s^2 + 4)".
+    std::string to_string() const;
+    void append_to(std::string& out) const;
+};
+
+// Transform of one term with every number exact. Coefficients and parameters are read with
+// Rational::from_double, so the decimals of the input come through as written (0.1 is
+// 1/10). Throws like checked_entry(), std::domain_error for a non-integer power of t and
+// std::invalid_argument for one past kMaxExactPower.
+ExactRationalFunction exact_transform(const ParsedTerm& term);
+
+// Transform of a sum, simplified like merge_like_terms and group_by_denominator but with
+// exact sums: "0.1*t + 0.2*t" is (3/10)/s^2 and "t/3 - t/3" is 0. Throws like exact_transform.
+std::vector<ExactRationalFunction> exact_transforms(const std::vector<ParsedTerm>& terms);
+
+// Joins exact transforms like append_sum for RationalFunction.
+void append_sum(std::string& out, const std::vector<ExactRationalFunction>& terms);
+
+} // namespace Laplace
+
+#endif // EXACT_TRANSFORM_H
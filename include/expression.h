@@ -0,0 +1,70 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Laplace {
+
+enum class ExpressionKind : uint8_t {
+    NUMBER,     // value; PI is folded in by the parser
+    VARIABLE,   // t
+    SUM,        // operands added
+    PRODUCT,    // operands multiplied
+    NEGATE,     // -operand
+    RECIPROCAL, // 1/operand, from division
+    POWER,      // operands {base, exponent}
+    SIN,        // Functions of their one operand
+    COS,
+    EXP,
+    SINH,
+    COSH,
+};
+
+using NodeId = uint32_t;
+
+struct ExpressionNode {
+    ExpressionKind kind;
+    double value;   // NUMBER only
+    uint32_t first; // Operands are ExpressionDag::operands(node)
+    uint32_t count;
+};
+
+// Parsed expression as a DAG of hash-consed nodes: making a node that already exists
+// returns the existing id, so a subexpression is stored once however often it occurs and
+// equal ids mean equal expressions. Nodes and their operand lists are flat vectors, and the
+// intern table is open addressing over node ids, so a DAG that is reset and refilled (one
+// per Parser) stops allocating once it has seen its largest input.
+class ExpressionDag {
+public:
+    // Empties the DAG, with the intern table sized for about `expected_nodes` nodes.
+    void reset(size_t expected_nodes);
+
+    NodeId number(double value);
+    NodeId variable() { return make(ExpressionKind::VARIABLE, nullptr, 0); }
+    NodeId unary(ExpressionKind kind, NodeId operand) { return make(kind, &operand, 1); }
+    NodeId power(NodeId base, NodeId exponent);
+    // SUM or PRODUCT of operands[0, count); a single operand is returned as it is
+    NodeId combine(ExpressionKind kind, const NodeId* operands, size_t count);
+
+    const ExpressionNode& node(NodeId id) const { return nodes_[id]; }
+    const NodeId* operands(NodeId id) const { return operands_.data() + nodes_[id].first; }
+    size_t size() const { return nodes_.size(); }
+    size_t operand_count() const { return operands_.size(); }
+
+private:
+    static constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+    std::vector<ExpressionNode> nodes_;
+    std::vector<NodeId> operands_;
+    std::vector<uint32_t> slots_; // Node ids by hash, kEmptySlot where free; size a power of two
+
+    NodeId make(ExpressionKind kind, const NodeId* operands, size_t count, double value = 0.0);
+    size_t hash(const ExpressionNode& node, const NodeId* operands) const;
+    void grow();
+};
+
+} // namespace Laplace
+
+#endif // EXPRESSION_H
@@ -0,0 +1,61 @@
+#ifndef FREQUENCY_RESPONSE_H
+#define FREQUENCY_RESPONSE_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include "rational_function.h"
+
+namespace Laplace {
+
+// Evaluates F(s) = sum of transform terms at many complex points, e.g. s = jw for a
+// frequency response or the nodes of a Bromwich contour.
+//
+// Each term is evaluated in its factored form gain * N(u) / D(u)^power (u = s - shift) with
+// complex Horner, and the quotient is taken with a scaled division, so points close to a
+// pole neither overflow nor lose precision to an expanded denominator. The inner loop runs
+// on AVX2+FMA (4 points) or SSE2 (2 points) when the CPU has them, scalar otherwise.
+// Terms of L{t^nu} with a fractional power or a gain in log form go through
+// RationalFunction::evaluate one point at a time instead.
+class FrequencyEvaluator {
+public:
+    enum class Simd { Scalar, SSE2, AVX2 };
+
+    explicit FrequencyEvaluator(const std::vector<RationalFunction>& terms);
+
+    // out[i] = F(s[i]) for i < count, with real and imaginary parts in separate arrays.
+    void evaluate(const double* s_re, const double* s_im, size_t count,
+                  double* out_re, double* out_im) const;
+
+    void evaluate(const std::vector<std::complex<double>>& s, std::vector<std::complex<double>>& out) const;
+
+    std::complex<double> evaluate(std::complex<double> s) const;
+
+    // Instruction set used by evaluate(); force() lowers it, e.g. to compare paths.
+    Simd simd() const { return simd_; }
+    void force(Simd simd);
+    static Simd best_supported();
+    static const char* name(Simd simd);
+
+    // Flattened term data, shared with the vector kernels.
+    struct Term {
+        double gain;
+        double shift;
+        int power;
+        size_t numerator_offset, numerator_size;
+        size_t denominator_offset, denominator_size;
+    };
+
+private:
+    std::vector<Term> terms_;
+    std::vector<double> coefficients_; // Numerators and denominators back to back, lowest power first
+    std::vector<RationalFunction> irregular_; // Fractional power or log gain: RationalFunction::evaluate per point
+    Simd simd_;
+};
+
+// n points s = j*w with w spaced logarithmically over [w_min, w_max].
+std::vector<std::complex<double>> log_frequency_grid(double w_min, double w_max, size_t n);
+
+} // namespace Laplace
+
+#endif // FREQUENCY_RESPONSE_H
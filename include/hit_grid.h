@@ -0,0 +1,104 @@
+#ifndef HIT_GRID_H
+#define HIT_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace Laplace {
+
+// Axis-aligned rectangle in window coordinates; contains() is half open like sf::Rect.
+struct HitRect {
+    float left = 0.0f;
+    float top = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+
+    bool contains(float x, float y) const {
+        return x >= left && y >= top && x < left + width && y < top + height;
+    }
+};
+
+// Uniform grid over the bounding box of a fixed set of rectangles, for finding the one
+// under the mouse without testing all of them. Each cell lists the rectangles overlapping
+// it, so a lookup tests only the few in one cell. The lists are stored back to back with
+// an offset per cell, in one allocation.
+class HitGrid {
+public:
+    static const int npos = -1;
+
+    HitGrid() = default;
+
+    // cell is the side of a grid cell; about the size of one rectangle keeps lists short.
+    explicit HitGrid(const std::vector<HitRect>& rects, float cell = 64.0f) : rects_(rects), cell_(cell) {
+        if (rects_.empty()) return;
+
+        float right = rects_[0].left + rects_[0].width;
+        float bottom = rects_[0].top + rects_[0].height;
+        left_ = rects_[0].left;
+        top_ = rects_[0].top;
+        for (const HitRect& r : rects_) {
+            left_ = std::min(left_, r.left);
+            top_ = std::min(top_, r.top);
+            right = std::max(right, r.left + r.width);
+            bottom = std::max(bottom, r.top + r.height);
+        }
+        columns_ = static_cast<size_t>(std::ceil((right - left_) / cell_)) + 1;
+        rows_ = static_cast<size_t>(std::ceil((bottom - top_) / cell_)) + 1;
+
+        // Count per cell, turn the counts into offsets, then fill
+        offsets_.assign(columns_ * rows_ + 1, 0);
+        for_each_cell([&](size_t c, int) { ++offsets_[c + 1]; });
+        for (size_t c = 1; c < offsets_.size(); ++c) offsets_[c] += offsets_[c - 1];
+        indices_.resize(offsets_.back());
+        std::vector<size_t> fill(offsets_.begin(), offsets_.end() - 1);
+        for_each_cell([&](size_t c, int i) { indices_[fill[c]++] = i; });
+    }
+
+    // Index of the first rectangle containing (x, y), or npos.
+    int find(float x, float y) const {
+        if (offsets_.empty() || x < left_ || y < top_) return npos;
+        size_t column = static_cast<size_t>((x - left_) / cell_);
+        size_t row = static_cast<size_t>((y - top_) / cell_);
+        if (column >= columns_ || row >= rows_) return npos;
+
+        size_t c = row * columns_ + column;
+        for (size_t k = offsets_[c]; k < offsets_[c + 1]; ++k) {
+            if (rects_[indices_[k]].contains(x, y)) return indices_[k];
+        }
+        return npos;
+    }
+
+    size_t size() const { return rects_.size(); }
+
+private:
+    std::vector<HitRect> rects_;
+    float cell_ = 64.0f;
+    float left_ = 0.0f;
+    float top_ = 0.0f;
+    size_t columns_ = 0;
+    size_t rows_ = 0;
+    std::vector<size_t> offsets_; // Cell c lists indices_[offsets_[c], offsets_[c + 1])
+    std::vector<int> indices_;    // In increasing order within a cell, so find() keeps the first match
+
+    template <typename Fn>
+    void for_each_cell(Fn fn) const {
+        for (size_t i = 0; i < rects_.size(); ++i) {
+            const HitRect& r = rects_[i];
+            size_t c0 = static_cast<size_t>((r.left - left_) / cell_);
+            size_t r0 = static_cast<size_t>((r.top - top_) / cell_);
+            size_t c1 = std::min(columns_ - 1, static_cast<size_t>((r.left + r.width - left_) / cell_));
+            size_t r1 = std::min(rows_ - 1, static_cast<size_t>((r.top + r.height - top_) / cell_));
+            for (size_t row = r0; row <= r1; ++row) {
+                for (size_t column = c0; column <= c1; ++column) {
+                    fn(row * columns_ + column, static_cast<int>(i));
+                }
+            }
+        }
+    }
+};
+
+} // namespace Laplace
+
+#endif // HIT_GRID_H
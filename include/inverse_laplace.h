@@ -0,0 +1,58 @@
+#ifndef INVERSE_LAPLACE_H
+#define INVERSE_LAPLACE_H
+
+#include <complex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "parser.h"
+
+namespace Laplace {
+
+// One term of an inverse transform: coefficient * t^t_power * exp(a*t) * osc(omega*t),
+// where osc is SIN, COS or UNRECOGNIZED for none. The same shape the forward families have.
+struct TimeTerm {
+    double coefficient = 0.0;
+    int t_power = 0;
+    double a = 0.0;
+    FunctionType oscillation = FunctionType::UNRECOGNIZED;
+    double omega = 0.0;
+
+    // Forward family with this shape (EXP, T_EXP_COS, T_N_EXP for t^2*exp(a*t), ...),
+    // UNKNOWN_COMPOUND if there is none.
+    FunctionType family() const;
+
+    // Text the forward parser reads back, e.g. "3*e^(-2*t)*cos(4*t)".
+    std::string to_string() const;
+};
+
+// A root of the denominator and how many times it repeats.
+struct Pole {
+    std::complex<double> location;
+    int multiplicity;
+};
+
+// Roots of a real polynomial (coefficients lowest power first) by Aberth-Ehrlich iteration,
+// with nearby roots merged into one pole when their spread is what a repeated root would show
+// in double precision. Complex poles come in exact conjugate pairs. Throws std::runtime_error
+// for a constant or zero polynomial.
+std::vector<Pole> find_poles(const std::vector<double>& polynomial);
+
+// f(t) for F(s) = numerator(s) / denominator(s) by partial fractions: residues at each pole
+// come from a Taylor expansion of the rest of F there. Throws std::runtime_error unless the
+// degree of the numerator is below that of the denominator.
+std::vector<TimeTerm> inverse_laplace(const std::vector<double>& numerator, const std::vector<double>& denominator);
+
+// Parses a rational expression in s ("(2*s + 3)/(s^2 + 4*s + 13)", "1/(s+1)^3 - 2/s") into a
+// numerator and denominator. Throws std::runtime_error on malformed input.
+void parse_rational(std::string_view expression, std::vector<double>& numerator, std::vector<double>& denominator);
+
+// parse_rational followed by inverse_laplace.
+std::vector<TimeTerm> inverse_laplace(std::string_view expression);
+
+// Terms joined like Laplace::to_string joins transforms; "0" for none.
+std::string to_string(const std::vector<TimeTerm>& terms);
+
+} // namespace Laplace
+
+#endif // INVERSE_LAPLACE_H
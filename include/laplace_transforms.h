@@ -3,31 +3,40 @@
 
 #include <string>
 #include <stdexcept> // For exceptions
+#include "parser.h" // FunctionType
+#include "rational_function.h"
 
-// Helper for factorial (n!)
+// Helper for factorial (n!), from the table in special_functions.h
 double factorial(int n);
 
 namespace Laplace {
-    std::string transform_constant(double c);
-    std::string transform_t_pow_n(int n, double coeff = 1.0);
-    std::string transform_exp(double a, double coeff = 1.0);
-    std::string transform_sin(double omega, double coeff = 1.0);
-    std::string transform_cos(double omega, double coeff = 1.0);
-    std::string transform_t_exp(double a, double coeff = 1.0);
-    std::string transform_t_sin(double omega, double coeff = 1.0);
-    std::string transform_t_cos(double omega, double coeff = 1.0);
-    std::string transform_exp_sin(double a, double omega, double coeff = 1.0);
-    std::string transform_exp_cos(double a, double omega, double coeff = 1.0);
-    std::string transform_sinh(double omega, double coeff = 1.0);
-    std::string transform_cosh(double omega, double coeff = 1.0);
-    std::string transform_t_sinh(double omega, double coeff = 1.0);
-    std::string transform_t_cosh(double omega, double coeff = 1.0);
-    std::string transform_exp_sinh(double a, double omega, double coeff = 1.0);
-    std::string transform_exp_cosh(double a, double omega, double coeff = 1.0);
-    std::string transform_t_exp_sin(double a, double omega, double coeff = 1.0);
-    std::string transform_t_exp_cos(double a, double omega, double coeff = 1.0);
-    std::string transform_t_exp_sinh(double a, double omega, double coeff = 1.0);
-    std::string transform_t_exp_cosh(double a, double omega, double coeff = 1.0);
+    RationalFunction transform_constant(double c);
+    RationalFunction transform_t_pow_n(int n, double coeff = 1.0);
+    RationalFunction transform_t_pow(double nu, double coeff = 1.0); // Real nu > -1, by Gamma(nu + 1)
+    RationalFunction transform_exp(double a, double coeff = 1.0);
+    RationalFunction transform_sin(double omega, double coeff = 1.0);
+    RationalFunction transform_cos(double omega, double coeff = 1.0);
+    RationalFunction transform_t_exp(double a, double coeff = 1.0);
+    RationalFunction transform_t_sin(double omega, double coeff = 1.0);
+    RationalFunction transform_t_cos(double omega, double coeff = 1.0);
+    RationalFunction transform_exp_sin(double a, double omega, double coeff = 1.0);
+    RationalFunction transform_exp_cos(double a, double omega, double coeff = 1.0);
+    RationalFunction transform_sinh(double omega, double coeff = 1.0);
+    RationalFunction transform_cosh(double omega, double coeff = 1.0);
+    RationalFunction transform_t_sinh(double omega, double coeff = 1.0);
+    RationalFunction transform_t_cosh(double omega, double coeff = 1.0);
+    RationalFunction transform_exp_sinh(double a, double omega, double coeff = 1.0);
+    RationalFunction transform_exp_cosh(double a, double omega, double coeff = 1.0);
+    RationalFunction transform_t_exp_sin(double a, double omega, double coeff = 1.0);
+    RationalFunction transform_t_exp_cos(double a, double omega, double coeff = 1.0);
+    RationalFunction transform_t_exp_sinh(double a, double omega, double coeff = 1.0);
+    RationalFunction transform_t_exp_cosh(double a, double omega, double coeff = 1.0);
+
+    // Whole family L{coeff * t^n * e^(at) * osc(omega*t)} for any integer n >= 0, where osc is
+    // SIN, COS, SINH, COSH or UNRECOGNIZED for none; without osc, n may be any real > -1.
+    // The hand-written functions above are the n <= 1 members, kept because the
+    // compile-time table shares them. Throws std::invalid_argument for other n.
+    RationalFunction transform_t_n_exp_osc(double n, double a, FunctionType oscillation, double omega, double coeff = 1.0);
 
 } // namespace Laplace
 
@@ -0,0 +1,54 @@
+#ifndef NUMBER_FORMAT_H
+#define NUMBER_FORMAT_H
+
+#include <cstddef>
+#include <string>
+
+namespace Laplace {
+
+enum class NumberStyle {
+    Shortest,   // Fewest digits that read back to the same double: 0.1, 1e+20, 0.3333333333333333
+    General,    // precision significant digits, like printf %g and the default ostream
+    Fixed,      // precision digits after the point, like %f
+    Scientific, // precision digits after the point of the mantissa, like %e
+};
+
+struct NumberFormat {
+    NumberStyle style = NumberStyle::Shortest;
+    int precision = 6; // Ignored by Shortest
+};
+
+// Room for any Shortest, General or Scientific text with precision up to 17.
+const size_t kNumberBufferSize = 32;
+
+// Writes value to [first, last) with std::to_chars: no locale, no allocation. Returns one
+// past the last character written, or nullptr when the text does not fit, which with
+// kNumberBufferSize only happens for Fixed (1e300 has 301 digits before the point).
+char* format_number(char* first, char* last, double value, const NumberFormat& format = NumberFormat());
+
+// Appends value to out; allocates only when out has to grow.
+void append_number(std::string& out, double value, const NumberFormat& format = NumberFormat());
+
+// value * e^log_scale as mantissa * 10^exponent, 1 <= |mantissa| < 10, for magnitudes past
+// double range. log_scale is itself a rounded double, so the result is only good to about
+// 2 * |ln(value * e^log_scale)| ulps: 12 digits for 171!, 10 for 100000!. The mantissa is
+// rounded to those `digits` and carries no noise past them.
+struct ScaledDecimal {
+    double mantissa;
+    long exponent;
+    int digits;
+};
+ScaledDecimal scaled_decimal(double value, double log_scale);
+
+// Format for a ScaledDecimal's mantissa given the one asked for: no more digits than it
+// has, and Scientific as Fixed, since the exponent is written separately.
+NumberFormat scaled_mantissa_format(const NumberFormat& format, int digits);
+
+// Appends value * e^log_scale: as append_number() when log_scale is 0, otherwise as the
+// mantissa in `format` followed by the exponent. 200! = e^log_gamma(201) is
+// "7.88657867365e+374", not the 7.88657867364752 a double mantissa would show.
+void append_scaled_number(std::string& out, double value, double log_scale, const NumberFormat& format = NumberFormat());
+
+} // namespace Laplace
+
+#endif // NUMBER_FORMAT_H
@@ -0,0 +1,55 @@
+#ifndef NUMERICAL_TRANSFORM_H
+#define NUMERICAL_TRANSFORM_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include "time_function.h"
+
+namespace Laplace {
+
+// F(s) at one point and an estimate of its absolute error.
+struct TransformEstimate {
+    std::complex<double> value;
+    double error = 0.0;
+};
+
+// F(s) = integral over t > 0 of f(t) exp(-s t), by double-exponential (exp-sinh) quadrature,
+// for expressions the closed-form table rejects. Needs Re s past the growth rate of f.
+//
+// The substitution t = exp(pi/2 sinh(x)) makes the integrand decay double exponentially at
+// both ends, which also absorbs integrable singularities at t = 0 such as 1/sqrt(t). The
+// trapezoidal rule in x is refined by halving the step, so every level reuses the previous
+// nodes, and the change between the last two levels is the error estimate.
+//
+// f is sampled once, at every node of every level, when the object is built; the nodes do
+// not depend on s, so any number of points reuse the same samples.
+class NumericalTransform {
+public:
+    // Throws std::invalid_argument unless 0 < tolerance < 1.
+    explicit NumericalTransform(const TimeFunction& f, double tolerance = 1e-10);
+
+    // Refines until the relative change drops below the tolerance or the levels run out.
+    TransformEstimate operator()(std::complex<double> s) const;
+
+    // out[i] = F(s[i]), with the points split across threads (0 = one per hardware thread).
+    void evaluate(const std::vector<std::complex<double>>& s, std::vector<TransformEstimate>& out,
+                  unsigned threads = 0) const;
+
+    // f(t) evaluations made when sampling.
+    size_t samples() const;
+
+private:
+    // Nodes a level adds: t_k and f(t_k) dt/dx at them.
+    struct Level {
+        std::vector<double> t;
+        std::vector<double> weighted;
+    };
+
+    std::vector<Level> levels_;
+    double tolerance_;
+};
+
+} // namespace Laplace
+
+#endif // NUMERICAL_TRANSFORM_H
@@ -0,0 +1,72 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "number_format.h"
+#include "rational_function.h"
+
+namespace Laplace {
+
+enum class OutputFormat { Plain, Latex, MathML, Json };
+
+// "plain", "latex", "mathml" or "json"; throws std::invalid_argument otherwise.
+OutputFormat parse_output_format(std::string_view name);
+
+// Renders results in one output format. Every method appends one result to `out` and
+// nothing else (no newline), so callers choose the buffer: a line of a batch block, a
+// StreamOutput, or a string of their own. Writers hold no state and may be shared
+// between threads.
+class OutputWriter {
+public:
+    explicit OutputWriter(const NumberFormat& numbers = NumberFormat()) : numbers_(numbers) {}
+    virtual ~OutputWriter() = default;
+
+    // F(s), the sum of the transforms of an expression's terms.
+    virtual void transform(std::string& out, const std::vector<RationalFunction>& terms) const = 0;
+
+    // A result that is already text, such as f(t) from the inverse transform.
+    virtual void text(std::string& out, std::string_view text) const = 0;
+
+    // A line that could not be solved.
+    virtual void error(std::string& out, std::string_view message) const = 0;
+
+protected:
+    NumberFormat numbers_;
+};
+
+// plain:  2/(s^2 + 4) - 3/s                     (RationalFunction::to_string)
+// latex:  \frac{2}{s^{2} + 4} - \frac{3}{s}     (math mode body, no $ delimiters)
+// mathml: <math xmlns="..."><mfrac>...</mfrac>...</math>
+// json:   {"transform":"2/(s^2 + 4) - 3/s","terms":[{"gain":2,"numerator":[1],...}]}
+//         one object per result, so a batch run is JSON Lines; "error" or "result" for the rest.
+//         "power" is fractional and "log_gain" present only where RationalFunction has them.
+std::unique_ptr<OutputWriter> make_output_writer(OutputFormat format, const NumberFormat& numbers = NumberFormat());
+
+// One growing buffer in front of a stream. Writers append to buffer(); end_line() ends
+// the result and hands the buffer to the stream once it passes flush_at bytes, so output
+// of any size goes through the same allocation.
+class StreamOutput {
+public:
+    explicit StreamOutput(std::ostream& stream, size_t flush_at = 1 << 20);
+    ~StreamOutput();
+
+    std::string& buffer() { return buffer_; }
+    void end_line();
+
+    // Writes out whatever is buffered. False once the stream has failed.
+    bool flush();
+
+private:
+    std::ostream& stream_;
+    std::string buffer_;
+    size_t flush_at_;
+};
+
+} // namespace Laplace
+
+#endif // OUTPUT_WRITER_H
@@ -0,0 +1,45 @@
+#ifndef PARALLEL_CHUNKS_H
+#define PARALLEL_CHUNKS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace Laplace {
+
+// Runs fn(worker, begin, end) over [0, count) on up to `threads` threads, the calling one
+// included as worker 0. Threads claim `chunk` indices at a time from a shared counter, so
+// uneven work still balances; `worker` lets each thread use state of its own.
+template <typename Fn>
+void parallel_worker_chunks(size_t count, unsigned threads, size_t chunk, Fn fn) {
+    std::atomic<size_t> next(0);
+    auto worker = [&](unsigned w) {
+        for (;;) {
+            size_t begin = next.fetch_add(chunk);
+            if (begin >= count) break;
+            fn(w, begin, std::min(begin + chunk, count));
+        }
+    };
+
+    size_t useful = (count + chunk - 1) / chunk;
+    std::vector<std::thread> pool;
+    for (unsigned w = 1; w < std::min<size_t>(threads, useful); ++w) {
+        pool.emplace_back(worker, w);
+    }
+    worker(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+// Runs fn(begin, end) over [0, count) on up to `threads` threads, as above.
+template <typename Fn>
+void parallel_chunks(size_t count, unsigned threads, size_t chunk, Fn fn) {
+    parallel_worker_chunks(count, threads, chunk, [&](unsigned, size_t begin, size_t end) { fn(begin, end); });
+}
+
+} // namespace Laplace
+
+#endif // PARALLEL_CHUNKS_H
@@ -2,8 +2,13 @@
 #define PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstddef>
 #include <stdexcept> // For exceptions
+#include "expression.h"
+#include "progress.h"
+#include "term_classifier.h"
 
 // --- Tokenizer Types ---
 enum class TokenType {
@@ -19,9 +24,22 @@ struct Token {
     Token(TokenType t, const char* txt_char);
 };
 
-// --- Tokenizer Function Declaration ---
+// Token that borrows its text from the input instead of owning a copy.
+// NUMBER values are converted with std::from_chars while tokenizing.
+struct TokenView {
+    TokenType type;
+    std::string_view text;
+    double value;
+};
+
+// --- Tokenizer Function Declarations ---
 std::vector<Token> tokenize(const std::string& input);
 
+// Zero-copy tokenizer: clears `tokens` and refills it, so a caller that keeps the vector
+// around allocates nothing per token. The views point into `input`, which must outlive them.
+// With `progress`, one stage counted in bytes of input.
+void tokenize(std::string_view input, std::vector<TokenView>& tokens, Laplace::Progress* progress = nullptr);
+
 // --- Parser Structures ---
 enum class FunctionType {
     UNRECOGNIZED = 0,
@@ -45,59 +63,123 @@ enum class FunctionType {
     T_EXP_COS,
     T_EXP_SINH,
     T_EXP_COSH,
+    T_N_EXP,      // t^n with the factors named after it, for any n; parameters {n, a, omega}
+    T_N_SIN,
+    T_N_COS,
+    T_N_SINH,
+    T_N_COSH,
+    T_N_EXP_SIN,
+    T_N_EXP_COS,
+    T_N_EXP_SINH,
+    T_N_EXP_COSH,
     UNKNOWN_COMPOUND
 };
 
+// Parameters of a term, stored inline: no family needs more than a handful,
+// so copying a ParsedTerm never touches the heap.
+class TermParameters {
+public:
+    static constexpr size_t capacity = 4;
+
+    void push_back(double value) {
+        if (size_ == capacity) throw std::length_error("Too many parameters for one term.");
+        values_[size_++] = value;
+    }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    double& operator[](size_t i) { return values_[i]; }
+    double operator[](size_t i) const { return values_[i]; }
+    const double* begin() const { return values_; }
+    const double* end() const { return values_ + size_; }
+
+private:
+    double values_[capacity] = {};
+    size_t size_ = 0;
+};
+
 struct ParsedTerm {
     double coefficient = 1.0; // Includes sign
     FunctionType type = FunctionType::UNRECOGNIZED;
-    std::vector<double> parameters; // For T_POW_N: {n}, EXP: {a}, SIN/COS: {omega}
-    std::string original_term_str;
-
-    std::string text_representation() const {
-        switch (type) {
-            case FunctionType::CONSTANT: return "constant";
-            case FunctionType::T_POW_N: return "t^" + std::to_string(static_cast<int>(parameters[0]));
-            case FunctionType::SIN: return "sin(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::COS: return "cos(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::EXP: return "exp(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::SINH: return "sinh(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::COSH: return "cosh(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::T_EXP: return "t*exp(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::T_SIN: return "t*sin(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::T_COS: return "t*cos(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::EXP_SIN: return "exp(" + std::to_string(parameters[0]) + "*t)*sin(" + std::to_string(parameters[1]) + "*t)";
-            case FunctionType::EXP_COS: return "exp(" + std::to_string(parameters[0]) + "*t)*cos(" + std::to_string(parameters[1]) + "*t)";
-            case FunctionType::T_SINH: return "t*sinh(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::T_COSH: return "t*cosh(" + std::to_string(parameters[0]) + "*t)";
-            case FunctionType::EXP_SINH: return "exp(" + std::to_string(parameters[0]) + "*t)*sinh(" + std::to_string(parameters[1]) + "*t)";
-            case FunctionType::EXP_COSH: return "exp(" + std::to_string(parameters[0]) + "*t)*cosh(" + std::to_string(parameters[1]) + "*t)";
-            case FunctionType::T_EXP_SIN: return "t*exp(" + std::to_string(parameters[0]) + "*t)*sin(" + std::to_string(parameters[1]) + "*t)";
-            case FunctionType::T_EXP_COS: return "t*exp(" + std::to_string(parameters[0]) + "*t)*cos(" + std::to_string(parameters[1]) + "*t)";
-            case FunctionType::T_EXP_SINH: return "t*exp(" + std::to_string(parameters[0]) + "*t)*sinh(" + std::to_string(parameters[1]) + "*t)";
-            case FunctionType::T_EXP_COSH: return "t*exp(" + std::to_string(parameters[0]) + "*t)*cosh(" + std::to_string(parameters[1]) + "*t)";
-            default: return "unrecognized_function";
-        }
-    }
+    TermParameters parameters; // For T_POW_N: {n}, EXP: {a}, SIN/COS: {omega}
+    std::string_view original_term_str; // Slice of the parsed input, valid while that string lives
+
+    // Readable form such as "t*exp(-2.000000*t)*sin(3.000000*t)", built from the transform registry.
+    std::string text_representation() const;
 };
 
 // --- Parser Class Declaration ---
+// Parsing is two passes. The first builds the expression as a hash-consed DAG
+// (Laplace::ExpressionDag): sums, products, quotients, powers and functions nest freely
+// and a repeated subexpression is one node. The second (Laplace::TermClassifier) expands
+// each top-level term of the DAG into products of table factors and names their family
+// from the transform registry, expanding each distinct node once.
+// A flat top-level term, a product of numbers, t^n and functions of c*t such as
+// 3*t^2*exp(-2*t)*sin(5*t), skips the DAG: the first pass classifies it as it reads it, with
+// the same arithmetic, so large flat sums cost no more than they did before the DAG.
+//
+// A Parser keeps its token buffer, DAG, classifier and result buffer between calls, so a
+// long-lived instance (one per worker thread) does no heap allocation once warmed up.
+// Not copyable; not safe to share between threads.
 class Parser {
 public:
+    Parser() = default;
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+
+    // Parses into a buffer owned by the parser. The result, and the original_term_str views
+    // inside it, stay valid until the next call or until `input` goes away. A top-level term
+    // that expands to several products, such as (t + 1)^2, gives one ParsedTerm for each,
+    // all with that term's text.
+    // With `progress`, tokenizing and the two passes are its next three stages, and stopping
+    // it abandons the parse with Laplace::Cancelled.
+    const std::vector<ParsedTerm>& parse(std::string_view input, Laplace::Progress* progress = nullptr);
+
+    // Same as parse(), returned as an independent copy.
     std::vector<ParsedTerm> parse_expression(const std::string& input);
 
 private:
-    std::vector<Token> tokens_;
-    size_t token_idx_;
+    // Deepest nesting of parentheses, function calls and exponents, which bounds the recursion
+    static constexpr int kMaxDepth = 200;
+
+    struct TopLevelTerm {
+        bool flat = false;
+        Laplace::FactorProduct product; // When flat
+        Laplace::NodeId node = 0;       // Otherwise
+        std::string_view text;
+    };
 
-    std::vector<ParsedTerm> parse_expression_in_parentheses_helper();
+    // What one parse builds lives in vectors that are cleared, not freed, by the next one:
+    // tokens, DAG, classifier products and results. They took over from the monotonic arena
+    // the parser once had, because the DAG's node and hash-slot arrays grow by reallocation,
+    // and an arena would hold every outgrown copy until its reset.
+    std::vector<TokenView> tokens_; // Views into the string being parsed
+    size_t token_idx_ = 0;
+    int depth_ = 0;
+    Laplace::Progress* progress_ = nullptr; // Of the parse in progress, if it has one
+    std::vector<ParsedTerm> terms_;
 
-    Token& current_token();
-    Token& peek_token(size_t offset = 1);
+    Laplace::ExpressionDag dag_;
+    Laplace::TermClassifier classifier_;
+    std::vector<Laplace::NodeId> operand_stack_; // Operands of the sums and products being built
+    std::vector<TopLevelTerm> top_level_;
+
+    const TokenView& current_token();
+    const TokenView& peek_token(size_t offset = 1);
     void consume_token();
-    double evaluate_simple_parameter_argument();
-    ParsedTerm parse_factor();
-    ParsedTerm parse_multiplication(); // Handles terms connected by * or / (higher precedence)
+    std::string_view source_since(const char* begin) const;
+
+    void parse_terms();
+    bool parse_flat_term(Laplace::FactorProduct& product);
+    bool parse_flat_factor(Laplace::FactorProduct& factor);
+    bool parse_flat_argument(double& omega, bool& has_t);
+    bool parse_flat_exponent(double& a);
+    Laplace::NodeId parse_sum();
+    Laplace::NodeId parse_product();
+    Laplace::NodeId parse_power();
+    Laplace::NodeId parse_exponent();
+    Laplace::NodeId parse_primary();
+    void add_terms(const TopLevelTerm& term);
+    void add_term(const Laplace::FactorProduct& product, std::string_view text);
 };
 
 #endif // PARSER_H
\ No newline at end of file
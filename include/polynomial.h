@@ -0,0 +1,70 @@
+#ifndef POLYNOMIAL_H
+#define POLYNOMIAL_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Laplace {
+
+// Dense polynomial with real coefficients, lowest power first, as RationalFunction stores
+// them. Results are trimmed of trailing zero coefficients but keep at least one, so zero
+// is {0}.
+using Polynomial = std::vector<double>;
+
+// Below this many coefficients in the shorter factor, multiply() uses the schoolbook
+// product; from there on the FFT one.
+const size_t kFftThreshold = 256;
+
+void trim(Polynomial& p);
+bool is_zero(const Polynomial& p);
+int degree(const Polynomial& p); // -1 for zero
+
+// a + sign * b
+Polynomial add(const Polynomial& a, const Polynomial& b, double sign = 1.0);
+
+// Schoolbook below kFftThreshold, FFT above (about where the FFT starts winning). Both are
+// exposed for benchmarks. The FFT product's error is about 1e-16 times the largest
+// coefficient times the length, so coefficients far below the largest (the ends of
+// (s + 1)^400, say) lose relative accuracy that the schoolbook product keeps.
+Polynomial multiply(const Polynomial& a, const Polynomial& b);
+Polynomial multiply_schoolbook(const Polynomial& a, const Polynomial& b);
+Polynomial multiply_fft(const Polynomial& a, const Polynomial& b);
+
+// p^n by repeated squaring.
+Polynomial power(const Polynomial& p, int n);
+
+// Product of all factors, multiplied pairwise as a balanced tree so the FFT sees large
+// operands instead of one growing product. {1} for no factors.
+Polynomial product(std::vector<Polynomial> factors);
+
+// a = quotient * b + remainder with degree(remainder) < degree(b).
+// Throws std::invalid_argument if b is zero.
+struct PolynomialDivision {
+    Polynomial quotient;
+    Polynomial remainder;
+};
+PolynomialDivision divide(const Polynomial& a, const Polynomial& b);
+
+// Monic greatest common divisor by Euclid's algorithm. A remainder counts as zero once
+// its coefficients are all below tolerance times the largest coefficient of the divisor,
+// so near-common roots are treated as common. gcd of two zeros is {0}.
+Polynomial gcd(Polynomial a, Polynomial b, double tolerance = 1e-9);
+
+Polynomial derivative(const Polynomial& p);
+
+// p(u) rewritten as a polynomial in s, where u = s - shift.
+Polynomial shift_polynomial(const Polynomial& p, double shift);
+
+// p(x) by Horner's rule, for double or std::complex<double> x.
+template <typename T>
+T evaluate(const Polynomial& p, T x) {
+    T value = 0.0;
+    for (size_t k = p.size(); k-- > 0;) {
+        value = value * x + p[k];
+    }
+    return value;
+}
+
+} // namespace Laplace
+
+#endif // POLYNOMIAL_H
@@ -0,0 +1,69 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+namespace Laplace {
+
+// Thrown out of a computation whose Progress was stopped. Not a std::exception, so the
+// handlers that report malformed input do not take it for an error.
+struct Cancelled {};
+
+// How far a long computation on one thread has got, and a way for another thread to call
+// it off. The work runs in a known number of stages; each announces how many items it has
+// with begin_stage() and counts them off with advance(), so fraction() only ever rises.
+// After stop() the next advance() or check() throws Cancelled. Stages take a Progress* and
+// skip all of this when it is null.
+class Progress {
+public:
+    explicit Progress(unsigned stages) : stages_(stages) {}
+
+    Progress(const Progress&) = delete;
+    Progress& operator=(const Progress&) = delete;
+
+    // Moves to the next stage, of `items` items. The first call starts stage 0.
+    void begin_stage(size_t items) {
+        check();
+        ++stage_;
+        items_ = items;
+        done_ = 0;
+        publish();
+    }
+
+    void advance(size_t items = 1) {
+        check();
+        done_ += items;
+        publish();
+    }
+
+    // For loops inside one item that can run long on their own.
+    void check() const {
+        if (stopped_.load(std::memory_order_relaxed)) throw Cancelled();
+    }
+
+    // Any thread.
+    void stop() { stopped_.store(true, std::memory_order_relaxed); }
+
+    // From 0 to 1 over all the stages. Any thread.
+    float fraction() const { return fraction_.load(std::memory_order_relaxed); }
+
+private:
+    const unsigned stages_;
+    unsigned stage_ = 0; // Stages begun; these three belong to the working thread
+    size_t items_ = 0;   // Of the current stage
+    size_t done_ = 0;
+    std::atomic<float> fraction_{0.0f};
+    std::atomic<bool> stopped_{false};
+
+    void publish() {
+        float within = items_ == 0 ? 1.0f : static_cast<float>(std::min(done_, items_)) / static_cast<float>(items_);
+        fraction_.store(std::min(1.0f, (static_cast<float>(stage_ - 1) + within) / static_cast<float>(stages_)),
+                        std::memory_order_relaxed);
+    }
+};
+
+} // namespace Laplace
+
+#endif // PROGRESS_H
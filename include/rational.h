@@ -0,0 +1,75 @@
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include "big_int.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Laplace {
+
+// Exact fraction in lowest terms with a positive denominator. Numerator and denominator
+// live inline as int64 while they fit, which covers textbook inputs: arithmetic there is
+// a few multiplies and a gcd, with the overflow checked by the compiler builtins. Only a
+// result that overflows moves to a BigInt pair on the heap, and one that shrinks back
+// into range returns inline, so the fast path is never lost for good.
+class Rational {
+public:
+    Rational() = default;
+    Rational(int64_t value); // Implicit, so integers mix freely into expressions
+    Rational(int64_t numerator, int64_t denominator); // Throws std::domain_error for 0 denominator
+    Rational(const BigInt& numerator, const BigInt& denominator);
+
+    // The simplest fraction within a few ulps of x, so a coefficient typed as 0.1 (or the
+    // product 0.1*3) reads back as 1/10 (3/10) rather than the binary value of the double.
+    // Falls back to the exact binary value when no small fraction is close enough.
+    // Throws std::invalid_argument for infinities and NaN.
+    static Rational from_double(double x);
+
+    bool is_inline() const { return !big_; }
+    bool is_zero() const { return !big_ && numerator_ == 0; }
+    bool is_integer() const;
+    int sign() const;
+
+    BigInt numerator() const;
+    BigInt denominator() const;
+    double to_double() const;
+
+    Rational operator-() const;
+    Rational reciprocal() const; // Throws std::domain_error for zero
+
+    friend Rational operator+(const Rational& a, const Rational& b);
+    friend Rational operator-(const Rational& a, const Rational& b);
+    friend Rational operator*(const Rational& a, const Rational& b);
+    friend Rational operator/(const Rational& a, const Rational& b);
+    Rational& operator+=(const Rational& other) { return *this = *this + other; }
+    Rational& operator-=(const Rational& other) { return *this = *this - other; }
+    Rational& operator*=(const Rational& other) { return *this = *this * other; }
+    Rational& operator/=(const Rational& other) { return *this = *this / other; }
+
+    static int compare(const Rational& a, const Rational& b); // -1, 0 or 1
+    friend bool operator==(const Rational& a, const Rational& b);
+    friend bool operator!=(const Rational& a, const Rational& b) { return !(a == b); }
+    friend bool operator<(const Rational& a, const Rational& b) { return compare(a, b) < 0; }
+
+    // "p" for integers, "p/q" otherwise
+    void append_to(std::string& out) const;
+    std::string to_string() const;
+
+private:
+    struct Big {
+        BigInt numerator, denominator;
+    };
+
+    int64_t numerator_ = 0; // Inline value, meaningful while big_ is null
+    int64_t denominator_ = 1;
+    std::shared_ptr<const Big> big_; // Immutable, so copies share it
+
+    // Already reduced, denominator positive, neither part INT64_MIN
+    static Rational make_inline(int64_t numerator, int64_t denominator);
+    static Rational make_big(BigInt numerator, BigInt denominator); // Reduces and normalizes
+};
+
+} // namespace Laplace
+
+#endif // RATIONAL_H
@@ -0,0 +1,59 @@
+#ifndef RATIONAL_FUNCTION_H
+#define RATIONAL_FUNCTION_H
+
+#include <complex>
+#include <string>
+#include <vector>
+#include "number_format.h"
+#include "progress.h"
+
+namespace Laplace {
+
+// Result of a single transform: F(s) = gain * N(u) / D(u)^power, with u = s - shift.
+// Every entry of the transform table is a rational function of the shifted variable u,
+// so keeping shift and power apart preserves the factored layout when printing while
+// numerator_in_s()/denominator_in_s() give the expanded coefficients for numerical work.
+// Polynomial coefficients are stored lowest power first.
+//
+// L{t^nu} for real nu leaves the rational functions in two ways, each with a field that is
+// zero everywhere else: a fractional part of the power (s^3.5) and a gain beyond double
+// range, kept as its logarithm (200! / s^201).
+struct RationalFunction {
+    double gain = 0.0;                // 0 means F(s) = 0
+    std::vector<double> numerator;    // N(u)
+    std::vector<double> denominator;  // D(u), monic for every table entry
+    int power = 1;                    // exponent applied to D(u)
+    double shift = 0.0;               // u = s - shift
+    double fractional_power = 0.0;    // in [0, 1), added to power
+    double log_gain = 0.0;            // F(s) is further multiplied by e^log_gain
+
+    bool is_zero() const;
+
+    // False for a fractional power, which has no polynomial denominator.
+    bool is_rational() const { return fractional_power == 0.0; }
+
+    // Expanded coefficients of gain * N(s - shift) and D(s - shift)^power. Throw
+    // std::domain_error unless is_rational(), and numerator_in_s() throws
+    // std::overflow_error when log_gain puts the coefficients beyond double range.
+    std::vector<double> numerator_in_s() const;
+    std::vector<double> denominator_in_s() const;
+
+    std::complex<double> evaluate(std::complex<double> s) const;
+
+    // Formatting is a separate step so the transform path never touches streams. The
+    // default format writes each coefficient with the fewest digits that round-trip.
+    std::string to_string(const NumberFormat& format = NumberFormat()) const;
+    void append_to(std::string& out, const NumberFormat& format = NumberFormat()) const;
+};
+
+// Joins the transforms of a sum of terms, e.g. "2/(s^2 + 4) - 3/s".
+std::string to_string(const std::vector<RationalFunction>& terms, const NumberFormat& format = NumberFormat());
+
+// Same text as to_string(terms), appended to out without a string per term. With
+// `progress`, one stage counted in terms.
+void append_sum(std::string& out, const std::vector<RationalFunction>& terms, const NumberFormat& format = NumberFormat(),
+                Progress* progress = nullptr);
+
+} // namespace Laplace
+
+#endif // RATIONAL_FUNCTION_H
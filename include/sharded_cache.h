@@ -0,0 +1,109 @@
+#ifndef SHARDED_CACHE_H
+#define SHARDED_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t size = 0;
+};
+
+// Bounded, thread-safe LRU map. Keys are spread over independently locked shards so
+// worker threads rarely wait on each other; each shard evicts its least recently used
+// entry once it holds capacity / shard_count entries.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache {
+public:
+    ShardedLruCache(size_t capacity, size_t shard_count) {
+        if (shard_count == 0) shard_count = 1;
+        shard_capacity_ = capacity / shard_count > 0 ? capacity / shard_count : 1;
+        for (size_t i = 0; i < shard_count; ++i) {
+            shards_.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    // Copies the cached value into `value` and marks it as recently used.
+    bool find(const Key& key, Value& value) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        value = it->second->second;
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void insert(const Key& key, Value value) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) { // Another thread got there first
+            it->second->second = std::move(value);
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return;
+        }
+        if (shard.entries.size() >= shard_capacity_) {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.entries.emplace_front(key, std::move(value));
+        shard.index.emplace(key, shard.entries.begin());
+    }
+
+    CacheStats stats() const {
+        CacheStats stats;
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.evictions = evictions_.load(std::memory_order_relaxed);
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            stats.size += shard->entries.size();
+        }
+        return stats;
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->index.clear();
+            shard->entries.clear();
+        }
+    }
+
+private:
+    using Entries = std::list<std::pair<Key, Value>>;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        Entries entries; // Most recently used first
+        std::unordered_map<Key, typename Entries::iterator, Hash> index;
+    };
+
+    Shard& shard_for(const Key& key) {
+        // Scramble the hash so shard selection does not reuse the bits the map buckets on
+        uint64_t h = static_cast<uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ull;
+        return *shards_[(h >> 32) % shards_.size()];
+    }
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t shard_capacity_ = 1;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+#endif // SHARDED_CACHE_H
@@ -0,0 +1,40 @@
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+#include <vector>
+#include "parser.h"
+#include "progress.h"
+#include "rational_function.h"
+
+namespace Laplace {
+
+// Simplification between parsing and printing. Each step keeps the sum the same and
+// keeps terms in the order they first appear, so "sin(2*t) + 3*sin(2*t) + cos(2*t)"
+// still reads left to right:
+//
+//   merge_like_terms      4*sin(2*t) + cos(2*t)
+//   group_by_denominator  (s + 8)/(s^2 + 4)
+//
+// Parameters and denominators are compared exactly, so only terms that are equal to the
+// last bit merge. A sum that cancels completely becomes a single zero term rather than
+// nothing, so it still prints as "0". Given a Progress, each step is one stage of it,
+// counted in input items, and throws Cancelled once it is stopped.
+
+// Adds the coefficients of terms with the same family and parameters; sums that come to
+// zero are dropped.
+std::vector<ParsedTerm> merge_like_terms(const std::vector<ParsedTerm>& terms, Progress* progress = nullptr);
+
+// Adds transforms with the same denominator, power and shift into one, whose numerator is
+// the sum of gain * N(u) and whose gain is 1. A shared log_gain stays with the group.
+std::vector<RationalFunction> group_by_denominator(const std::vector<RationalFunction>& transforms,
+                                                   Progress* progress = nullptr);
+
+// The whole sum over one denominator, expanded in s: each distinct factor D(u) appears at
+// the highest power any term gives it. Common factors of the result's numerator and
+// denominator are not cancelled. Throws like RationalFunction::numerator_in_s() for terms
+// that have no polynomial form.
+RationalFunction common_denominator(const std::vector<RationalFunction>& transforms);
+
+} // namespace Laplace
+
+#endif // SIMPLIFY_H
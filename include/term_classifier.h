@@ -0,0 +1,80 @@
+#ifndef TERM_CLASSIFIER_H
+#define TERM_CLASSIFIER_H
+
+#include <cstddef>
+#include <vector>
+#include "expression.h"
+#include "progress.h"
+
+namespace Laplace {
+
+// Upper bound on the products one expression may expand to beyond the few per node that
+// any input needs, so a product of many long sums of unlike terms fails with a message
+// rather than exhausting memory, while a flat sum of any length does not.
+constexpr size_t kMaxExpandedProducts = size_t(1) << 20;
+
+// Highest whole power of a sum that is multiplied out: (t + 1)^n.
+constexpr int kMaxExpandedPower = 64;
+
+// coefficient * t^t_power * exp(a*t) * oscillation(omega*t): the shape the transform table's
+// families are keyed by (see FactorSignature).
+struct FactorProduct {
+    double coefficient = 1.0;
+    double t_power = 0.0;
+    bool has_exp = false;
+    double a = 0.0;
+    ExpressionKind oscillation = ExpressionKind::NUMBER; // SIN, COS, SINH or COSH; NUMBER for none
+    double omega = 0.0;
+
+    bool has_oscillation() const { return oscillation != ExpressionKind::NUMBER; }
+    bool is_constant() const { return t_power == 0.0 && !has_exp && !has_oscillation(); }
+};
+
+// The pass after parsing: expands a node of the DAG into a sum of FactorProducts,
+// distributing products over sums and powers, folding constants and merging exponentials.
+// Like products are added up after every multiplication, so (t + 1)^64 is 65 products.
+// Each node is expanded once and the result kept, so a subexpression repeated across a
+// large input costs one expansion. What the table cannot express (a product of two
+// oscillations, t in an exponent, division by a sum) throws std::runtime_error.
+//
+// Function arguments must be linear in t. A bare constant keeps its shorthand meaning,
+// sin(2) is sin(2*t), and a constant offset is expanded: sin(w*t + b) is
+// cos(b)*sin(w*t) + sin(b)*cos(w*t), exp(a*t + b) is e^b*exp(a*t).
+class TermClassifier {
+public:
+    struct Range {
+        size_t first;
+        size_t count;
+    };
+
+    // Forgets every result; call when the DAG is reset. Long expansions check `progress`,
+    // when given, and throw Cancelled once it is stopped.
+    void reset(const ExpressionDag& dag, const Progress* progress = nullptr);
+
+    // Products whose sum is `node`; read them with product(). Valid until reset().
+    Range classify(NodeId node);
+    const FactorProduct& product(size_t i) const { return products_[i]; }
+
+private:
+    static constexpr size_t kUnclassified = SIZE_MAX;
+    static constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+    const ExpressionDag* dag_ = nullptr;
+    const Progress* progress_ = nullptr;
+    size_t max_products_ = 0; // kMaxExpandedProducts past what the DAG needs unexpanded
+    std::vector<FactorProduct> products_; // Results of every node, and scratch between them
+    std::vector<Range> results_;          // By node id; count kUnclassified until classified
+    std::vector<uint32_t> merge_slots_;   // merge_like()'s hash table, kept for its capacity
+
+    Range expand(NodeId node);
+    Range multiply(Range left, Range right);
+    Range merge_like(Range range);
+    Range append(const FactorProduct& product);
+    FactorProduct single(Range range, const char* what) const;
+    Range classify_function(ExpressionKind kind, NodeId argument);
+    Range classify_power(NodeId base, NodeId exponent);
+};
+
+} // namespace Laplace
+
+#endif // TERM_CLASSIFIER_H
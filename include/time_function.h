@@ -0,0 +1,59 @@
+#ifndef TIME_FUNCTION_H
+#define TIME_FUNCTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Laplace {
+
+// f(t) compiled from an expression in t to bytecode for a small stack machine. Unlike
+// Parser it accepts any expression, including the ones the transform table has no row
+// for: "e^(-t)*e^(-2*t)", "t^2*sin(t)", "sqrt(t)*cos(t)", "1/(1 + t^2)".
+//
+//   expression := term (('+' | '-') term)*
+//   term       := unary (('*' | '/') unary | power)*    -- juxtaposition multiplies: "2t"
+//                                                       -- but not before a number: "2 3" is an error
+//   unary      := ('+' | '-') unary | power
+//   power      := primary ('^' unary)?                  -- right associative
+//   primary    := NUMBER | 't' | 'PI' | 'pi' | 'e' | function '(' expression ')' | '(' expression ')'
+//
+// Functions are sin, cos, tan, sinh, cosh, tanh, exp, sqrt, log (natural), ln and abs.
+// Constant subexpressions are folded while compiling, e^x becomes exp(x) and integer
+// powers up to 64 become multiplications. As in Parser, a constant argument of sin, cos,
+// sinh, cosh or exp is a frequency: sin(2) is sin(2t), and exp(2) and e^(2) are exp(2t).
+// Without parentheses e^2 is the number e^2, which Parser rejects.
+class TimeFunction {
+public:
+    // Throws std::runtime_error on malformed input.
+    explicit TimeFunction(std::string_view expression);
+
+    double operator()(double t) const;
+
+    // out[i] = f(t[i]) for i < count. Each instruction runs over a block of points before
+    // the next one, so the interpreter's dispatch is paid once per block, not per point.
+    void evaluate(const double* t, double* out, size_t count) const;
+
+    size_t instruction_count() const { return code_.size(); }
+
+private:
+    enum class Op : uint8_t {
+        Constant, Time, Add, Subtract, Multiply, Divide, Power, IntegerPower, Negate,
+        Sin, Cos, Tan, Sinh, Cosh, Tanh, Exp, Sqrt, Log, Abs,
+    };
+
+    struct Instruction {
+        Op op;
+        double operand; // Constant: its value; IntegerPower: the exponent
+    };
+
+    class Compiler;
+
+    std::vector<Instruction> code_;
+    size_t stack_depth_ = 0;
+};
+
+} // namespace Laplace
+
+#endif // TIME_FUNCTION_H
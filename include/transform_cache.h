@@ -0,0 +1,43 @@
+#ifndef TRANSFORM_CACHE_H
+#define TRANSFORM_CACHE_H
+
+#include <cstddef>
+#include "transform_registry.h"
+#include "parser.h"
+#include "sharded_cache.h"
+
+namespace Laplace {
+
+// Identifies a transform up to its coefficient: the family and its parameter values.
+struct TermKey {
+    FunctionType type = FunctionType::UNRECOGNIZED;
+    size_t parameter_count = 0;
+    double parameters[TermParameters::capacity] = {};
+
+    explicit TermKey(const ParsedTerm& term);
+    bool operator==(const TermKey& other) const;
+};
+
+struct TermKeyHash {
+    size_t operator()(const TermKey& key) const;
+};
+
+// Memoizes transform_term for the building blocks that repeat across expressions
+// (sin(2*t), exp(-3*t), ...). Entries are stored for a unit coefficient and scaled on
+// the way out, so 3*sin(2*t) and 5*sin(2*t) share one entry. Safe to share between threads.
+class TransformCache {
+public:
+    explicit TransformCache(size_t capacity = 1 << 14, size_t shard_count = 16);
+
+    RationalFunction transform(const ParsedTerm& term);
+
+    CacheStats stats() const { return cache_.stats(); }
+    void clear() { cache_.clear(); }
+
+private:
+    ShardedLruCache<TermKey, RationalFunction, TermKeyHash> cache_;
+};
+
+} // namespace Laplace
+
+#endif // TRANSFORM_CACHE_H
@@ -0,0 +1,55 @@
+#ifndef TRANSFORM_REGISTRY_H
+#define TRANSFORM_REGISTRY_H
+
+#include <cstddef>
+#include "parser.h"
+#include "rational_function.h"
+
+namespace Laplace {
+
+// Marks a family whose power of t is not fixed but carried as its first parameter (t^n).
+constexpr double kAnyPower = -1.0;
+
+// Shape of the product that the parser folds into a family: the power of t it carries,
+// whether it has an exp(a*t) factor and which sin/cos/sinh/cosh factor, if any.
+// Parameters are then ordered: n (for kAnyPower), a (for exp), omega (for the oscillation).
+struct FactorSignature {
+    double t_power;
+    bool has_exp;
+    FunctionType oscillation; // UNRECOGNIZED when there is none
+};
+
+using TransformHandler = RationalFunction (*)(const double* parameters, double coeff);
+
+// One row of the transform table. Adding a family means adding its FunctionType and a row;
+// Solve, ParsedTerm::text_representation and the parser's product folding all read from here.
+struct TransformEntry {
+    FunctionType type;
+    size_t arity;             // Number of parameters the handler reads
+    const char* name;         // Used in error messages
+    const char* pattern;      // Text form; {0}, {1} are parameters, {n} is parameter 0, bare if whole
+    FactorSignature signature;
+    TransformHandler handler; // nullptr for types with no transform
+};
+
+// Row for `type`; every FunctionType has one.
+const TransformEntry& transform_entry(FunctionType type);
+
+// Family the parser should give a product of the given shape, or nullptr if there is none.
+const TransformEntry* find_product_family(double t_power, bool has_exp, FunctionType oscillation);
+
+// Row for a term that is about to be used, after the checks every caller needs: throws
+// std::runtime_error for terms without a transform or with missing parameters.
+const TransformEntry& checked_entry(const ParsedTerm& term);
+
+// Transform of a parsed term through its registry row: one arity check, one indirect call.
+// Throws like checked_entry().
+RationalFunction transform_term(const ParsedTerm& term);
+
+// f(t) of a parsed term, read off its row's signature: coefficient * t^n * exp(a*t) * osc(omega*t).
+// Throws like checked_entry().
+double evaluate_term(const ParsedTerm& term, double t);
+
+} // namespace Laplace
+
+#endif // TRANSFORM_REGISTRY_H
@@ -1,8 +1,18 @@
 #include <iostream>
 #include "laplace_transforms.h" 
+#include "transform_registry.h"
 #include "parser.h"  
+#include "transform_cache.h"
+#include "canonical_form.h"
+#include "simplify.h"
+#include "progress.h"
 #include <locale>
 #include <codecvt> 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 class Solve {
     
@@ -12,6 +22,102 @@ class Solve {
 
     public : 
 
+    // Terms of the last solved expression and their transforms, for the plot panel.
+    // Both are empty when the expression did not parse.
+    std::vector<ParsedTerm> terms;
+    std::vector<Laplace::RationalFunction> transforms;
+
+    // Per-term transform cache shared by every solve in the process (GUI and batch workers).
+    static Laplace::TransformCache &term_cache() {
+        static Laplace::TransformCache cache;
+        return cache;
+    }
+
+    // Whole-expression results keyed by Laplace::canonical_key, shared like term_cache().
+    static ShardedLruCache<std::string, std::string> &result_cache() {
+        static ShardedLruCache<std::string, std::string> cache(1 << 16, 16);
+        return cache;
+    }
+
+    // Transforms of terms after the simplification stage: like terms merged, then transforms
+    // over the same denominator added, or everything over one denominator when `common`.
+    static std::vector<Laplace::RationalFunction> simplified_transforms(const std::vector<ParsedTerm> &terms, bool common = false) {
+
+        std::vector<ParsedTerm> merged = Laplace::merge_like_terms(terms);
+        std::vector<Laplace::RationalFunction> transforms;
+        transforms.reserve(merged.size());
+
+        for (const ParsedTerm& term : merged) {
+            transforms.push_back(term_cache().transform(term));
+        }
+
+        if (common) return {Laplace::common_denominator(transforms)};
+        return Laplace::group_by_denominator(transforms);
+    }
+
+    // Parses one expression in t and returns its simplified transform, one rational function
+    // per distinct denominator.
+    // Throws std::runtime_error on malformed input, so callers decide how to report it.
+    // Holds no state of its own: the batch front end calls it from several threads, one Parser each.
+    static std::vector<Laplace::RationalFunction> transform_terms(Parser &parser, const std::string &input_function) {
+        return simplified_transforms(parser.parse(input_function));
+    }
+
+    // Same as transform_terms, formatted as text. Formatting is the last, separate step.
+    static std::string laplace_of(Parser &parser, const std::string &input_function) {
+        return Laplace::to_string(transform_terms(parser, input_function));
+    }
+
+    // Transform of an expression given by its canonical key, as text. Every input that shares
+    // the key gets the same answer (terms in canonical order), so it is looked up in and
+    // stored to result_cache().
+    static std::string laplace_of_canonical(const std::string &key) {
+        std::string result;
+        if (result_cache().find(key, result)) return result;
+
+        result = Laplace::to_string(transforms_of_canonical(key));
+        result_cache().insert(key, result);
+        return result;
+    }
+
+    // The transforms behind laplace_of_canonical(), for writers that need the structure
+    // rather than the text, or for a common denominator. Uses the term cache only.
+    static std::vector<Laplace::RationalFunction> transforms_of_canonical(const std::string &key, bool common = false) {
+        return simplified_transforms(Laplace::decode_canonical_key(key), common);
+    }
+
+    // Stages of solve_into(), for the Laplace::Progress it is given: tokenizing, parsing,
+    // classification, merging, the transforms, grouping and formatting.
+    static constexpr unsigned kSolveStages = 7;
+
+    // Parses input_function into `terms` (like terms merged) and their transforms grouped by
+    // denominator into `transforms`, and appends the sum to `text` (after whatever the
+    // caller already put there).
+    // Every stage reports to `progress`, when given; once it is stopped the solve is abandoned
+    // wherever it has got to and false returned. Throws std::runtime_error on malformed input.
+    static bool solve_into(Parser &parser, const std::string &input_function, std::vector<ParsedTerm> &terms,
+                           std::vector<Laplace::RationalFunction> &transforms, std::string &text,
+                           Laplace::Progress *progress = nullptr) {
+        try {
+            terms = Laplace::merge_like_terms(parser.parse(input_function, progress), progress);
+            transforms.clear();
+            transforms.reserve(terms.size());
+            if (progress) progress->begin_stage(terms.size());
+            for (const ParsedTerm& term : terms) {
+                transforms.push_back(term_cache().transform(term));
+                if (progress) progress->advance();
+            }
+            transforms = Laplace::group_by_denominator(transforms, progress);
+            for (ParsedTerm& term : terms) {
+                term.original_term_str = {}; // Points into input_function, which the caller may drop
+            }
+            Laplace::append_sum(text, transforms, Laplace::NumberFormat(), progress);
+        } catch (const Laplace::Cancelled&) {
+            return false;
+        }
+        return true;
+    }
+
     Solve(std::wstring &inputString) {
 
         std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
@@ -19,136 +125,152 @@ class Solve {
         std::string input_function = converter.to_bytes(inputString);
 
 
-        parser = Parser(); 
-
         try {
-            std::vector<ParsedTerm> terms = parser.parse_expression(input_function);
-            std::string total_laplace_transform = "";
-
-            for (size_t i = 0; i < terms.size(); ++i) {
-                ParsedTerm term = terms[i];
-                std::string term_laplace_str;
-
-            //Debugining lines
-            // std::cout << "DEBUG: Term " << i << ": Coeff=" << term.coefficient
-            //                 << ", Type=" << static_cast<int>(term.type)
-            //                 << ", Params={";
-            //         for (double p : term.parameters) {
-            //             std::cout << p << ", ";
-            //         }
-            //         std::cout << "}" << std::endl;
-
-                switch (term.type) {
-                    case FunctionType::CONSTANT:
-                        term_laplace_str = Laplace::transform_constant(term.coefficient);
-                        break;
-                    case FunctionType::T_POW_N:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing exponent for t");
-                        term_laplace_str = Laplace::transform_t_pow_n(static_cast<int>(term.parameters[0]), term.coefficient);
-                        break;
-                    case FunctionType::SIN:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing omega for sin");
-                        term_laplace_str = Laplace::transform_sin(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::COS:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing omega for cos");
-                        term_laplace_str = Laplace::transform_cos(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::EXP:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing 'a' for exp");
-                        term_laplace_str = Laplace::transform_exp(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::SINH:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing omega for sinh");
-                        term_laplace_str = Laplace::transform_sinh(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::COSH:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing omega for cosh");
-                        term_laplace_str = Laplace::transform_cosh(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::T_EXP:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing 'a' for t*exp");
-                        term_laplace_str = Laplace::transform_t_exp(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::T_SIN:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing omega for t*sin");
-                        term_laplace_str = Laplace::transform_t_sin(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::T_COS:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing omega for t*cos");
-                        term_laplace_str = Laplace::transform_t_cos(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::EXP_SIN:
-                        if (term.parameters.size() < 2) throw std::runtime_error("Missing 'a' or 'omega' for exp*sin");
-                        term_laplace_str = Laplace::transform_exp_sin(term.parameters[0], term.parameters[1], term.coefficient);
-                        break;
-                    case FunctionType::EXP_COS:
-                        if (term.parameters.size() < 2) throw std::runtime_error("Missing 'a' or 'omega' for exp*cos");
-                        term_laplace_str = Laplace::transform_exp_cos(term.parameters[0], term.parameters[1], term.coefficient);
-                        break;
-                    case FunctionType::T_SINH:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing omega for t*sinh");
-                        term_laplace_str = Laplace::transform_t_sinh(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::T_COSH:
-                        if (term.parameters.empty()) throw std::runtime_error("Missing omega for t*cosh");
-                        term_laplace_str = Laplace::transform_t_cosh(term.parameters[0], term.coefficient);
-                        break;
-                    case FunctionType::EXP_SINH:
-                        if (term.parameters.size() < 2) throw std::runtime_error("Missing 'a' or 'omega' for exp*sinh");
-                        term_laplace_str = Laplace::transform_exp_sinh(term.parameters[0], term.parameters[1], term.coefficient);
-                        break;
-                    case FunctionType::EXP_COSH:
-                        if (term.parameters.size() < 2) throw std::runtime_error("Missing 'a' or 'omega' for exp*cosh");
-                        term_laplace_str = Laplace::transform_exp_cosh(term.parameters[0], term.parameters[1], term.coefficient);
-                        break;
-                    case FunctionType::T_EXP_SIN:
-                        if (term.parameters.size() < 2) throw std::runtime_error("Missing 'a' or 'omega' for t*exp*sin");
-                        term_laplace_str = Laplace::transform_t_exp_sin(term.parameters[0], term.parameters[1], term.coefficient);
-                        break;
-                    case FunctionType::T_EXP_COS:
-                        if (term.parameters.size() < 2) throw std::runtime_error("Missing 'a' or 'omega' for t*exp*cos");
-                        term_laplace_str = Laplace::transform_t_exp_cos(term.parameters[0], term.parameters[1], term.coefficient);
-                        break;
-                    case FunctionType::T_EXP_SINH:
-                        if (term.parameters.size() < 2) throw std::runtime_error("Missing 'a' or 'omega' for t*exp*sinh");
-                        term_laplace_str = Laplace::transform_t_exp_sinh(term.parameters[0], term.parameters[1], term.coefficient);
-                        break;
-                    case FunctionType::T_EXP_COSH:
-                        if (term.parameters.size() < 2) throw std::runtime_error("Missing 'a' or 'omega' for t*exp*cosh");
-                        term_laplace_str = Laplace::transform_t_exp_cosh(term.parameters[0], term.parameters[1], term.coefficient);
-                        break;
-
-                    case FunctionType::UNRECOGNIZED:
-                        term_laplace_str = "[ERROR: Unrecognized Term]";
-                        break;
-                    default:
-                        term_laplace_str = "[ERROR: Unknown Function Type]";
-                        break;
-                }
-
-                if (i == 0) {
-                    total_laplace_transform = term_laplace_str;
-                } else {
-                    if (term.coefficient < 0) {
-                        // If it's negative, the sign is already part of term_laplace_str, so just append
-                        total_laplace_transform += " " + term_laplace_str;
-                    } else {
-                        // If it's positive, add a '+'
-                        total_laplace_transform += " + " + term_laplace_str;
-                    }
-                }
-            }
+            // "L{input} >>> F(s)" is built in one buffer and converted once
+            std::string display = "L{" + input_function + "} >>> ";
+            solve_into(parser, input_function, terms, transforms, display);
 
-            inputString = L"L{" + inputString + L"}" + L" >>> " + converter.from_bytes(total_laplace_transform);
+            inputString = converter.from_bytes(display);
 
         } catch (const std::runtime_error& e) {
+            terms.clear();
+            transforms.clear();
             std::cerr << "Error: " << e.what() << std::endl;
         } catch (const std::exception& e) {
+            terms.clear();
+            transforms.clear();
             std::cerr << "An unexpected error occurred: " << e.what() << std::endl;
         }
 
 }
 
 
-} ;
\ No newline at end of file
+} ;
+
+
+// Solves on a worker thread so the window keeps drawing while a large expression is
+// transformed. Each submit() or cancel() starts a new generation and stops the running
+// solve's Progress, which every stage from parsing to formatting checks as it goes, so stale
+// work ends early; poll() only returns the newest submission's result.
+class AsyncSolver {
+public:
+    struct Result {
+        bool solved = false;   // False when the input did not parse
+        std::wstring display;  // "L{f(t)} >>> F(s)" when solved
+        std::vector<ParsedTerm> terms;
+        std::vector<Laplace::RationalFunction> transforms;
+    };
+
+    AsyncSolver() : worker_([this] { run(); }) {}
+
+    ~AsyncSolver() {
+        cancel();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        worker_.join();
+    }
+
+    AsyncSolver(const AsyncSolver&) = delete;
+    AsyncSolver& operator=(const AsyncSolver&) = delete;
+
+    void submit(const std::wstring &input) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        unsigned generation = ++generation_;
+        pending_ = Request{input, generation};
+        ready_.reset();
+        busy_ = true;
+        if (running_) running_->stop();
+        wake_.notify_one();
+    }
+
+    // The input changed: whatever is queued or running is no longer wanted.
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+        pending_.reset();
+        ready_.reset();
+        busy_ = false;
+        if (running_) running_->stop();
+    }
+
+    // The finished result of the latest submit(), once.
+    std::optional<Result> poll() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::optional<Result> result = std::move(ready_);
+        ready_.reset();
+        return result;
+    }
+
+    bool busy() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return busy_;
+    }
+
+    // How far the running solve has got, over all its stages.
+    float progress() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return running_ ? running_->fraction() : 0.0f;
+    }
+
+private:
+    struct Request {
+        std::wstring input;
+        unsigned generation;
+    };
+
+    Parser parser_; // Worker thread only
+    std::atomic<unsigned> generation_{0};
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::optional<Request> pending_;
+    std::optional<Result> ready_;
+    Laplace::Progress* running_ = nullptr; // Of the solve in progress on the worker
+    bool busy_ = false;
+    bool stop_ = false;
+    std::thread worker_; // Last, so everything it touches exists before it starts
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this] { return stop_ || pending_; });
+            if (stop_) return;
+            Request request = std::move(*pending_);
+            pending_.reset();
+            Laplace::Progress progress(Solve::kSolveStages);
+            running_ = &progress;
+
+            lock.unlock();
+            Result result;
+            bool finished = solve(request, result, progress);
+            lock.lock();
+            running_ = nullptr;
+            if (finished && request.generation == generation_) {
+                ready_ = std::move(result);
+                busy_ = false;
+            }
+        }
+    }
+
+    // False when a newer generation made the request stale before it finished.
+    bool solve(const Request &request, Result &result, Laplace::Progress &progress) {
+        std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
+        std::string input_function = converter.to_bytes(request.input);
+
+        try {
+            std::string display = "L{" + input_function + "} >>> ";
+            if (!Solve::solve_into(parser_, input_function, result.terms, result.transforms, display, &progress)) {
+                return false;
+            }
+            result.solved = true;
+            result.display = converter.from_bytes(display);
+        } catch (const std::exception& e) {
+            result = Result();
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+        return generation_ == request.generation;
+    }
+};
@@ -0,0 +1,340 @@
+// Headless batch front end: no SFML, same Parser and Laplace table as the GUI.
+// Reads one expression per line (stdin or a file) and writes one result per line, in input order.
+//
+//   laplace_batch [-j threads] [-o output] [--stats] [--inverse] [--numeric s1,s2,...]
+//                 [--format plain|latex|mathml|json] [--common-denominator | --exact] [input]
+//
+// Lines that fail to parse produce "error: <message>" so the output stays aligned with the input.
+// Lines that parse to the same canonical expression are solved once and share the answer.
+// --stats prints the cache counters to stderr when the run ends.
+// --inverse reads rational expressions in s instead and writes f(t) by partial fractions.
+// --numeric gives lines the transform table rejects a second chance: f(t) is compiled and F is
+// computed by quadrature at the listed points, e.g. "numeric: F(1) = 0.25 +/- 3e-15; F(2+1i) = ...".
+// --format picks the output writer: plain text (the default), LaTeX, MathML, or one JSON
+// object per line with the structure of every term.
+// Like terms are merged and terms over the same denominator added; --common-denominator
+// goes further and writes each transform as a single fraction.
+// --exact writes every coefficient as an exact fraction, "0.1*sin(t/3)" giving
+// (1/30)/(s^2 + 1/9), with the input's decimals read as written.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Solve.cpp"
+#include "command_line.h"
+#include "inverse_laplace.h"
+#include "exact_transform.h"
+#include "numerical_transform.h"
+#include "output_writer.h"
+#include "parallel_chunks.h"
+
+namespace {
+
+// Lines are processed a block at a time so memory stays bounded however long the input is.
+const size_t kBlockSize = 1 << 16;
+
+struct BatchOptions {
+    unsigned threads = 0; // 0 = one per hardware thread
+    std::string input_path;
+    std::string output_path;
+    bool print_stats = false;
+    bool inverse = false;
+    std::vector<std::complex<double>> numeric_points; // Empty = no quadrature fallback
+    Laplace::OutputFormat format = Laplace::OutputFormat::Plain;
+    bool common_denominator = false;
+    bool exact = false;
+};
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [-j threads] [-o output] [--stats] [--inverse] [--numeric s1,s2,...]\n"
+              << "       [--format plain|latex|mathml|json] [--common-denominator | --exact] [input]\n"
+              << "Reads one expression in t per line (stdin if no input file is given)\n"
+              << "and writes its Laplace transform on the matching output line.\n"
+              << "With --inverse, reads rational expressions in s and writes f(t).\n"
+              << "With --numeric, lines without a closed form get F(s) by quadrature at the\n"
+              << "given points instead of an error, e.g. --numeric 1,2.5,1+2i.\n"
+              << "--format writes each result as plain text (default), LaTeX, MathML or JSON.\n"
+              << "--common-denominator writes each transform as a single fraction.\n"
+              << "--exact writes coefficients as exact fractions, e.g. (1/3)/(s^2 + 1/9).\n";
+}
+
+// "2", "-0.5", "3i", "1+2i", "1-2j"
+bool parse_point(const std::string& text, std::complex<double>& point) {
+    const char* begin = text.c_str();
+    char* end = nullptr;
+    double first = std::strtod(begin, &end);
+    if (end == begin) return false;
+    if (*end == '\0') {
+        point = {first, 0.0};
+        return true;
+    }
+    if ((*end == 'i' || *end == 'j') && end[1] == '\0') {
+        point = {0.0, first};
+        return true;
+    }
+    const char* imag_begin = end;
+    double second = std::strtod(imag_begin, &end);
+    if (end == imag_begin || (*imag_begin != '+' && *imag_begin != '-') || (*end != 'i' && *end != 'j') || end[1] != '\0') {
+        return false;
+    }
+    point = {first, second};
+    return true;
+}
+
+bool parse_points(const std::string& list, std::vector<std::complex<double>>& points) {
+    size_t start = 0;
+    for (;;) {
+        size_t comma = list.find(',', start);
+        std::complex<double> point;
+        if (!parse_point(list.substr(start, comma - start), point)) return false;
+        points.push_back(point);
+        if (comma == std::string::npos) return true;
+        start = comma + 1;
+    }
+}
+
+bool parse_options(int argc, char** argv, BatchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            if (!Laplace::parse_count_argument(argv[++i], options.threads)) return false;
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            options.output_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            options.print_stats = true;
+        } else if (std::strcmp(argv[i], "--inverse") == 0) {
+            options.inverse = true;
+        } else if (std::strcmp(argv[i], "--numeric") == 0 && i + 1 < argc) {
+            if (!parse_points(argv[++i], options.numeric_points)) return false;
+        } else if (std::strcmp(argv[i], "--common-denominator") == 0) {
+            options.common_denominator = true;
+        } else if (std::strcmp(argv[i], "--exact") == 0) {
+            options.exact = true;
+        } else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            try {
+                options.format = Laplace::parse_output_format(argv[++i]);
+            } catch (const std::invalid_argument&) {
+                return false;
+            }
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            return false;
+        } else if (options.input_path.empty()) {
+            options.input_path = argv[i];
+        } else {
+            return false;
+        }
+    }
+    return !(options.exact && options.common_denominator);
+}
+
+// Runs fn(parser, i) for i in [0, count) on one thread per parser. Workers claim small
+// chunks from a shared counter so a few expensive lines do not leave the other threads idle.
+template <typename Fn>
+void parallel_for(size_t count, std::vector<Parser>& parsers, Fn fn) {
+    Laplace::parallel_worker_chunks(count, static_cast<unsigned>(parsers.size()), 256,
+                                    [&](unsigned worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            fn(parsers[worker], i);
+        }
+    });
+}
+
+std::string complex_text(std::complex<double> z) {
+    char buffer[64];
+    if (z.imag() == 0.0) {
+        std::snprintf(buffer, sizeof buffer, "%.12g", z.real());
+    } else {
+        std::snprintf(buffer, sizeof buffer, "%.12g%+.12gi", z.real(), z.imag());
+    }
+    return buffer;
+}
+
+// Writes the result for a line the closed-form path rejected with `error`: F by quadrature
+// at the --numeric points, or the error itself if there are none or the line does not
+// compile as f(t).
+void fallback(const std::string& line, const char* error, const std::vector<std::complex<double>>& points,
+              const Laplace::OutputWriter& writer, std::string& out) {
+    out.clear();
+    if (points.empty()) {
+        writer.error(out, error);
+        return;
+    }
+    try {
+        Laplace::NumericalTransform transform{Laplace::TimeFunction(line)};
+        std::string result = "numeric:";
+        char uncertainty[32];
+        for (size_t k = 0; k < points.size(); ++k) {
+            Laplace::TransformEstimate estimate = transform(points[k]);
+            result += k == 0 ? " F(" : "; F(";
+            result += complex_text(points[k]) + ") = ";
+            if (!std::isfinite(estimate.value.real()) || !std::isfinite(estimate.value.imag())) {
+                result += "diverges"; // Re s is left of where the integral converges
+                continue;
+            }
+            std::snprintf(uncertainty, sizeof uncertainty, "%.2g", estimate.error);
+            result += complex_text(estimate.value) + " +/- " + uncertainty;
+        }
+        writer.text(out, result);
+    } catch (const std::exception&) {
+        writer.error(out, error);
+    }
+}
+
+// Solves lines[0..count) into results[0..count). Lines are parsed into canonical keys
+// first; each distinct key is then solved once (or found in Solve::result_cache()) and
+// its answer copied to every line that shares it. Returns how many lines were duplicates.
+size_t solve_block(const std::vector<std::string>& lines, size_t count,
+                   std::vector<std::string>& results, std::vector<Parser>& parsers,
+                   const BatchOptions& options, const Laplace::OutputWriter& writer) {
+    std::vector<std::string> keys(count);
+    std::vector<char> failed(count, 0);
+
+    parallel_for(count, parsers, [&](Parser& parser, size_t i) {
+        try {
+            keys[i] = Laplace::canonical_key(parser.parse(lines[i]));
+        } catch (const std::exception& e) {
+            fallback(lines[i], e.what(), options.numeric_points, writer, results[i]);
+            failed[i] = 1;
+        }
+    });
+
+    // Serial pass: the first line with each key owns it
+    std::vector<size_t> owner(count);
+    std::vector<size_t> unique;
+    std::unordered_map<std::string_view, size_t> first_with_key;
+    first_with_key.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        owner[i] = i;
+        if (failed[i]) continue;
+        auto inserted = first_with_key.emplace(keys[i], i);
+        if (inserted.second) {
+            unique.push_back(i);
+        } else {
+            owner[i] = inserted.first->second;
+        }
+    }
+
+    parallel_for(unique.size(), parsers, [&](Parser&, size_t u) {
+        size_t i = unique[u];
+        try {
+            if (options.exact) {
+                std::string text;
+                Laplace::append_sum(text, Laplace::exact_transforms(Laplace::decode_canonical_key(keys[i])));
+                results[i].clear();
+                writer.text(results[i], text);
+            } else if (options.format == Laplace::OutputFormat::Plain && !options.common_denominator) {
+                results[i] = Solve::laplace_of_canonical(keys[i]); // Whole answers are cached as plain text
+            } else {
+                results[i].clear();
+                writer.transform(results[i], Solve::transforms_of_canonical(keys[i], options.common_denominator));
+            }
+        } catch (const std::exception& e) {
+            fallback(lines[i], e.what(), options.numeric_points, writer, results[i]);
+        }
+    });
+
+    for (size_t i = 0; i < count; ++i) {
+        if (owner[i] != i) results[i] = results[owner[i]];
+    }
+    return count - unique.size() - static_cast<size_t>(std::count(failed.begin(), failed.end(), 1));
+}
+
+// Inverse mode: each line is independent and has no cache, so it is one parallel pass.
+void invert_block(const std::vector<std::string>& lines, size_t count,
+                  std::vector<std::string>& results, std::vector<Parser>& parsers,
+                  const Laplace::OutputWriter& writer) {
+    parallel_for(count, parsers, [&](Parser&, size_t i) {
+        results[i].clear();
+        try {
+            writer.text(results[i], Laplace::to_string(Laplace::inverse_laplace(lines[i])));
+        } catch (const std::exception& e) {
+            writer.error(results[i], e.what());
+        }
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BatchOptions options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::ios::sync_with_stdio(false);
+
+    std::ifstream input_file;
+    if (!options.input_path.empty()) {
+        input_file.open(options.input_path);
+        if (!input_file) {
+            std::cerr << "Error: cannot open " << options.input_path << std::endl;
+            return 1;
+        }
+    }
+    std::istream& in = options.input_path.empty() ? std::cin : input_file;
+
+    std::ofstream output_file;
+    if (!options.output_path.empty()) {
+        output_file.open(options.output_path, std::ios::binary);
+        if (!output_file) {
+            std::cerr << "Error: cannot open " << options.output_path << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.output_path.empty() ? std::cout : output_file;
+    std::unique_ptr<Laplace::OutputWriter> writer = Laplace::make_output_writer(options.format);
+
+    unsigned thread_count = options.threads ? options.threads : std::thread::hardware_concurrency();
+    if (thread_count == 0) thread_count = 1;
+
+    std::vector<Parser> parsers(thread_count);
+    std::vector<std::string> lines(kBlockSize);
+    std::vector<std::string> results(kBlockSize);
+    Laplace::StreamOutput output(out);
+    size_t duplicates = 0;
+
+    for (;;) {
+        size_t count = 0;
+        while (count < kBlockSize && std::getline(in, lines[count])) {
+            if (!lines[count].empty() && lines[count].back() == '\r') lines[count].pop_back();
+            ++count;
+        }
+        if (count == 0) break;
+
+        if (options.inverse) {
+            invert_block(lines, count, results, parsers, *writer);
+        } else {
+            duplicates += solve_block(lines, count, results, parsers, options, *writer);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            output.buffer() += results[i];
+            output.end_line();
+        }
+
+        if (count < kBlockSize) break;
+    }
+
+    output.flush();
+    out.flush();
+
+    if (options.print_stats) {
+        CacheStats terms = Solve::term_cache().stats();
+        CacheStats results = Solve::result_cache().stats();
+        std::cerr << "term cache: " << terms.hits << " hits, " << terms.misses << " misses, "
+                  << terms.evictions << " evictions, " << terms.size << " entries\n"
+                  << "result cache: " << results.hits << " hits, " << results.misses << " misses, "
+                  << results.evictions << " evictions, " << results.size << " entries\n"
+                  << "duplicate lines solved once: " << duplicates << std::endl;
+    }
+    return out ? 0 : 1;
+}
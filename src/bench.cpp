@@ -0,0 +1,456 @@
+// Microbenchmarks for the tokenizer, the parser, every table transform and the full Solve path
+// on a fixed corpus, from one term to thousands. No SFML. Prints JSON to stdout (or -o file)
+// so runs from two builds can be diffed or compared by a script.
+//
+//   laplace_bench [--filter text] [--min-time seconds] [-o output]
+//
+// Each benchmark is calibrated to run for min-time / 5 per repetition; ns_per_op is the best
+// of five repetitions. Allocations are counted by replacing the global operator new, so
+// allocs_per_op and alloc_bytes_per_op are exact for the code under test.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "Solve.cpp"
+#include "../include/exact_transform.h"
+#include "../include/hit_grid.h"
+#include "../include/polynomial.h"
+#include "../include/special_functions.h"
+
+// --- Allocation counting ---
+
+namespace {
+
+std::atomic<size_t> g_allocations(0);
+std::atomic<size_t> g_allocated_bytes(0);
+
+void* counted_allocate(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* counted_allocate_aligned(std::size_t size, std::align_val_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    void* p = _aligned_malloc(size ? size : 1, align);
+#else
+    void* p = std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align));
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void release_aligned(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return counted_allocate(size); }
+void* operator new[](std::size_t size) { return counted_allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return counted_allocate_aligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return counted_allocate_aligned(size, alignment); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release_aligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release_aligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release_aligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { release_aligned(p); }
+
+namespace {
+
+// --- Harness ---
+
+// Keeps a result alive so the work producing it is not optimized away.
+template <typename T>
+void keep(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct BenchOptions {
+    std::string filter;
+    double min_time = 0.5; // Seconds per benchmark
+    std::string output_path;
+};
+
+struct Result {
+    std::string name;
+    size_t iterations = 0;    // Per repetition
+    double ns_per_op = 0.0;
+    double allocs_per_op = 0.0;
+    double alloc_bytes_per_op = 0.0;
+    size_t input_bytes = 0;   // Text consumed per op; 0 for benchmarks that take no input
+};
+
+const int kRepetitions = 5;
+
+double elapsed_ns(const std::function<void()>& op, size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) op();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+Result measure(const std::string& name, size_t input_bytes, const std::function<void()>& op, double min_time) {
+    op(); // Warm caches and buffers that are reused across calls
+
+    // Grow the iteration count until one repetition takes min_time / kRepetitions
+    const double target_ns = min_time * 1e9 / kRepetitions;
+    size_t iterations = 1;
+    for (;;) {
+        double ns = elapsed_ns(op, iterations);
+        if (ns >= target_ns || iterations >= (size_t(1) << 32)) break;
+        double scale = ns > 0.0 ? 1.2 * target_ns / ns : 10.0;
+        iterations = static_cast<size_t>(static_cast<double>(iterations) * std::min(std::max(scale, 1.5), 10.0));
+    }
+
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.input_bytes = input_bytes;
+    result.ns_per_op = 1e300;
+
+    size_t allocations = g_allocations.load();
+    size_t bytes = g_allocated_bytes.load();
+    for (int rep = 0; rep < kRepetitions; ++rep) {
+        result.ns_per_op = std::min(result.ns_per_op, elapsed_ns(op, iterations) / static_cast<double>(iterations));
+    }
+    double ops = static_cast<double>(iterations) * kRepetitions;
+    result.allocs_per_op = static_cast<double>(g_allocations.load() - allocations) / ops;
+    result.alloc_bytes_per_op = static_cast<double>(g_allocated_bytes.load() - bytes) / ops;
+    return result;
+}
+
+// --- Corpus ---
+
+// n terms cycling through the table's families with varying parameters, all of which the
+// parser accepts. The same n always gives the same text.
+std::string generated_expression(size_t n) {
+    static const char* const kTemplates[] = {
+        "%g*sin(%g*t)", "%g*cos(%g*t)", "%g*e^(-%g*t)", "%g*t^%.0f", "%g*sinh(%g*t)",
+        "%g*t*e^(-%g*t)", "%g*e^(-%g*t)*sin(%g*t)", "%g*t*e^(-%g*t)*cos(%g*t)", "%g*t*cosh(%g*t)", "%g",
+    };
+    const size_t template_count = sizeof(kTemplates) / sizeof(kTemplates[0]);
+
+    std::string text;
+    char buffer[96];
+    for (size_t i = 0; i < n; ++i) {
+        double a = 1.0 + static_cast<double>(i % 7);
+        double b = 0.5 * static_cast<double>(1 + i % 11);
+        double c = static_cast<double>(2 + i % 5);
+        std::snprintf(buffer, sizeof buffer, kTemplates[i % template_count], a, i % template_count == 3 ? c : b, c);
+        if (i > 0) text += i % 3 == 0 ? " - " : " + ";
+        text += buffer;
+    }
+    return text;
+}
+
+struct CorpusEntry {
+    std::string name;
+    std::string text;
+};
+
+std::vector<CorpusEntry> corpus() {
+    return {
+        {"short", "sin(2*t)"},
+        {"medium", "3*t^2 + t*e^(-2*t)*sin(5*t) + 5*sin(4*t) + 2*e^(-t)*cos(3*t) + 7"},
+        {"terms_100", generated_expression(100)},
+        {"terms_1000", generated_expression(1000)},
+        {"terms_5000", generated_expression(5000)},
+    };
+}
+
+// --- Output ---
+
+// The calculator buttons as UI::setupLabels places them, outline included: 6 function keys
+// in rows of 3, then 20 keypad keys in rows of 5.
+std::vector<Laplace::HitRect> button_rects() {
+    std::vector<Laplace::HitRect> rects;
+    for (int i = 0; i < 6; ++i) {
+        rects.push_back({20.0f + (i % 3) * 80.0f - 2.0f, 300.0f + (i / 3) * 60.0f - 2.0f, 74.0f, 54.0f});
+    }
+    for (int j = 0; j < 20; ++j) {
+        rects.push_back({500.0f + (j % 5) * 60.0f - 2.0f, 300.0f + (j / 5) * 60.0f - 2.0f, 54.0f, 54.0f});
+    }
+    return rects;
+}
+
+std::string json_number(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof buffer, "%.6g", value);
+    return buffer;
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results, const BenchOptions& options) {
+    out << "{\n  \"context\": {\n"
+#if defined(__VERSION__)
+        << "    \"compiler\": \"" << __VERSION__ << "\",\n"
+#endif
+#ifdef NDEBUG
+        << "    \"assertions\": false,\n"
+#else
+        << "    \"assertions\": true,\n"
+#endif
+        << "    \"min_time_seconds\": " << json_number(options.min_time) << ",\n"
+        << "    \"repetitions\": " << kRepetitions << "\n  },\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        double ops_per_second = 1e9 / r.ns_per_op;
+        out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << json_number(r.ns_per_op)
+            << ", \"allocs_per_op\": " << json_number(r.allocs_per_op)
+            << ", \"alloc_bytes_per_op\": " << json_number(r.alloc_bytes_per_op)
+            << ", \"ops_per_second\": " << json_number(ops_per_second);
+        if (r.input_bytes > 0) {
+            out << ", \"input_bytes\": " << r.input_bytes
+                << ", \"mb_per_second\": " << json_number(ops_per_second * static_cast<double>(r.input_bytes) / 1e6);
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool parse_options(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            options.min_time = std::atof(argv[++i]);
+            if (!(options.min_time > 0.0)) return false;
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            options.output_path = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--filter text] [--min-time seconds] [-o output]\n";
+        return 2;
+    }
+
+    std::vector<Result> results;
+    auto run = [&](const std::string& name, size_t input_bytes, const std::function<void()>& op) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+        std::cerr << name << "..." << std::endl;
+        results.push_back(measure(name, input_bytes, op, options.min_time));
+    };
+
+    const std::vector<CorpusEntry> entries = corpus();
+
+    // Tokenizer: the zero-copy overload with a reused buffer, and the owning one
+    for (const CorpusEntry& entry : entries) {
+        std::vector<TokenView> tokens;
+        run("tokenize/" + entry.name, entry.text.size(), [&]() {
+            tokenize(entry.text, tokens);
+            keep(tokens.data());
+        });
+        run("tokenize_owning/" + entry.name, entry.text.size(), [&]() {
+            std::vector<Token> owned = tokenize(entry.text);
+            keep(owned.data());
+        });
+    }
+
+    // Parser: a long-lived instance (as the batch workers use it) and parse_expression's copy
+    for (const CorpusEntry& entry : entries) {
+        Parser parser;
+        run("parse/" + entry.name, entry.text.size(), [&]() {
+            keep(parser.parse(entry.text).data());
+        });
+        run("parse_expression/" + entry.name, entry.text.size(), [&]() {
+            std::vector<ParsedTerm> terms = parser.parse_expression(entry.text);
+            keep(terms.data());
+        });
+    }
+
+    // Every table transform, called directly
+    using Laplace::RationalFunction;
+    const std::pair<const char*, std::function<RationalFunction()>> transforms[] = {
+        {"constant", [] { return Laplace::transform_constant(3.0); }},
+        {"t_pow_n", [] { return Laplace::transform_t_pow_n(4, 2.0); }},
+        {"t_pow_n/200", [] { return Laplace::transform_t_pow_n(200, 2.0); }},
+        {"t_pow_real", [] { return Laplace::transform_t_pow(2.5, 2.0); }},
+        {"exp", [] { return Laplace::transform_exp(-2.0); }},
+        {"sin", [] { return Laplace::transform_sin(3.0); }},
+        {"cos", [] { return Laplace::transform_cos(3.0); }},
+        {"t_exp", [] { return Laplace::transform_t_exp(-2.0); }},
+        {"t_sin", [] { return Laplace::transform_t_sin(3.0); }},
+        {"t_cos", [] { return Laplace::transform_t_cos(3.0); }},
+        {"exp_sin", [] { return Laplace::transform_exp_sin(-2.0, 3.0); }},
+        {"exp_cos", [] { return Laplace::transform_exp_cos(-2.0, 3.0); }},
+        {"sinh", [] { return Laplace::transform_sinh(3.0); }},
+        {"cosh", [] { return Laplace::transform_cosh(3.0); }},
+        {"t_sinh", [] { return Laplace::transform_t_sinh(3.0); }},
+        {"t_cosh", [] { return Laplace::transform_t_cosh(3.0); }},
+        {"exp_sinh", [] { return Laplace::transform_exp_sinh(-2.0, 3.0); }},
+        {"exp_cosh", [] { return Laplace::transform_exp_cosh(-2.0, 3.0); }},
+        {"t_exp_sin", [] { return Laplace::transform_t_exp_sin(-2.0, 3.0); }},
+        {"t_exp_cos", [] { return Laplace::transform_t_exp_cos(-2.0, 3.0); }},
+        {"t_exp_sinh", [] { return Laplace::transform_t_exp_sinh(-2.0, 3.0); }},
+        {"t_exp_cosh", [] { return Laplace::transform_t_exp_cosh(-2.0, 3.0); }},
+        {"t_n_exp_cos/1", [] { return Laplace::transform_t_n_exp_osc(1, -2.0, FunctionType::COS, 3.0); }},
+        {"t_n_exp_cos/5", [] { return Laplace::transform_t_n_exp_osc(5, -2.0, FunctionType::COS, 3.0); }},
+        {"t_n_exp_cos/50", [] { return Laplace::transform_t_n_exp_osc(50, -2.0, FunctionType::COS, 3.0); }},
+    };
+    for (const auto& transform : transforms) {
+        run(std::string("transform/") + transform.first, 0, [&]() {
+            RationalFunction result = transform.second();
+            keep(result.gain);
+        });
+    }
+
+    // Formatting a transform, the last step of every solve
+    const RationalFunction formatted = Laplace::transform_t_exp_cos(-2.0, 3.0, 5.0);
+    run("format/t_exp_cos", 0, [&]() {
+        std::string text = formatted.to_string();
+        keep(text.data());
+    });
+
+    // Gamma over the exponents people write for t^nu, against the C library
+    std::vector<double> gamma_arguments;
+    for (double x = 0.55; x < 30.0; x += 0.25) gamma_arguments.push_back(x);
+    run("gamma/lanczos", 0, [&]() {
+        double sum = 0.0;
+        for (double x : gamma_arguments) sum += Laplace::gamma_function(x);
+        keep(sum);
+    });
+    run("gamma/std_tgamma", 0, [&]() {
+        double sum = 0.0;
+        for (double x : gamma_arguments) sum += std::tgamma(x);
+        keep(sum);
+    });
+
+    // Button under the mouse: scanning every button against the grid index, over a sweep
+    // of the whole 1200x600 window (most points miss, as most clicks land elsewhere)
+    const std::vector<Laplace::HitRect> rects = button_rects();
+    const Laplace::HitGrid grid(rects);
+    std::vector<std::pair<float, float>> probes;
+    for (float y = 0.5f; y < 600.0f; y += 7.0f) {
+        for (float x = 0.5f; x < 1200.0f; x += 7.0f) probes.push_back({x, y});
+    }
+    run("hit_test_linear/keypad", 0, [&]() {
+        int hits = 0;
+        for (const auto& p : probes) {
+            for (size_t i = 0; i < rects.size(); ++i) {
+                if (rects[i].contains(p.first, p.second)) { hits += static_cast<int>(i); break; }
+            }
+        }
+        keep(hits);
+    });
+    run("hit_test_grid/keypad", 0, [&]() {
+        int hits = 0;
+        for (const auto& p : probes) {
+            int i = grid.find(p.first, p.second);
+            if (i != Laplace::HitGrid::npos) hits += i;
+        }
+        keep(hits);
+    });
+
+    // Polynomial products either side of kFftThreshold
+    for (size_t n : {64, 256, 1024}) {
+        Laplace::Polynomial a(n), b(n);
+        for (size_t k = 0; k < n; ++k) {
+            a[k] = 1.0 + static_cast<double>(k % 7);
+            b[k] = 2.0 - static_cast<double>(k % 5);
+        }
+        run("multiply_schoolbook/" + std::to_string(n), 0, [&]() {
+            Laplace::Polynomial p = Laplace::multiply_schoolbook(a, b);
+            keep(p.data());
+        });
+        run("multiply_fft/" + std::to_string(n), 0, [&]() {
+            Laplace::Polynomial p = Laplace::multiply_fft(a, b);
+            keep(p.data());
+        });
+    }
+
+    // End to end: parse, transform each term without caches, format
+    for (const CorpusEntry& entry : entries) {
+        Parser parser;
+        run("solve_uncached/" + entry.name, entry.text.size(), [&]() {
+            std::vector<RationalFunction> transformed;
+            for (const ParsedTerm& term : parser.parse(entry.text)) {
+                transformed.push_back(Laplace::transform_term(term));
+            }
+            std::string text = Laplace::to_string(transformed);
+            keep(text.data());
+        });
+    }
+
+    // The same in exact mode, which also merges like terms and groups denominators; set
+    // against solve_uncached it is the price of exact coefficients
+    for (const CorpusEntry& entry : entries) {
+        Parser parser;
+        run("solve_exact/" + entry.name, entry.text.size(), [&]() {
+            std::string text;
+            Laplace::append_sum(text, Laplace::exact_transforms(parser.parse(entry.text)));
+            keep(text.data());
+        });
+    }
+
+    // Fraction sums on the inline int64 path against the same sums once they are BigInt
+    std::vector<Laplace::Rational> small_fractions, big_fractions;
+    const Laplace::Rational big_scale(Laplace::BigInt(INT64_MAX) * Laplace::BigInt(3), 1);
+    for (int k = 1; k <= 64; ++k) {
+        small_fractions.emplace_back(k, 1 + k % 8);
+        big_fractions.push_back(Laplace::Rational(k, 1 + k % 8) * big_scale);
+    }
+    run("rational_sum/inline", 0, [&]() {
+        Laplace::Rational sum;
+        for (const Laplace::Rational& r : small_fractions) sum += r;
+        keep(&sum);
+    });
+    run("rational_sum/big", 0, [&]() {
+        Laplace::Rational sum;
+        for (const Laplace::Rational& r : big_fractions) sum += r;
+        keep(&sum);
+    });
+
+    // End to end as the GUI runs it: Solve with its shared term cache, already warm
+    for (const CorpusEntry& entry : entries) {
+        const std::wstring input(entry.text.begin(), entry.text.end());
+        run("solve/" + entry.name, entry.text.size(), [&]() {
+            std::wstring text = input;
+            Solve solve(text);
+            keep(text.data());
+        });
+    }
+
+    if (options.output_path.empty()) {
+        write_json(std::cout, results, options);
+        return std::cout ? 0 : 1;
+    }
+    std::ofstream out(options.output_path);
+    write_json(out, results, options);
+    return out ? 0 : 1;
+}
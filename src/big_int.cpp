@@ -0,0 +1,307 @@
+#include "../include/big_int.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Laplace {
+
+namespace {
+
+using Limbs = std::vector<uint32_t>;
+
+void trim(Limbs& limbs) {
+    while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+}
+
+int compare_magnitude(const Limbs& a, const Limbs& b) {
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+Limbs add_magnitude(const Limbs& a, const Limbs& b) {
+    const Limbs& longer = a.size() >= b.size() ? a : b;
+    const Limbs& shorter = a.size() >= b.size() ? b : a;
+    Limbs sum(longer.size() + 1);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < longer.size(); ++i) {
+        uint64_t s = uint64_t(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+        sum[i] = static_cast<uint32_t>(s);
+        carry = s >> 32;
+    }
+    sum[longer.size()] = static_cast<uint32_t>(carry);
+    trim(sum);
+    return sum;
+}
+
+// a - b for |a| >= |b|
+Limbs subtract_magnitude(const Limbs& a, const Limbs& b) {
+    Limbs difference(a.size());
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        int64_t d = int64_t(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = d < 0 ? 1 : 0;
+        difference[i] = static_cast<uint32_t>(d);
+    }
+    trim(difference);
+    return difference;
+}
+
+Limbs multiply_magnitude(const Limbs& a, const Limbs& b) {
+    if (a.empty() || b.empty()) return {};
+    Limbs product(a.size() + b.size(), 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < b.size(); ++j) {
+            uint64_t p = uint64_t(a[i]) * b[j] + product[i + j] + carry;
+            product[i + j] = static_cast<uint32_t>(p);
+            carry = p >> 32;
+        }
+        product[i + b.size()] = static_cast<uint32_t>(carry);
+    }
+    trim(product);
+    return product;
+}
+
+Limbs divide_small(const Limbs& a, uint32_t divisor, uint32_t& remainder) {
+    Limbs quotient(a.size());
+    uint64_t rest = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        uint64_t current = (rest << 32) | a[i];
+        quotient[i] = static_cast<uint32_t>(current / divisor);
+        rest = current % divisor;
+    }
+    trim(quotient);
+    remainder = static_cast<uint32_t>(rest);
+    return quotient;
+}
+
+// Shifts left by bits < 32 into `size` limbs (at least enough to hold the result).
+Limbs shift_left(const Limbs& a, int bits, size_t size) {
+    Limbs shifted(size, 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t v = uint64_t(a[i]) << bits;
+        shifted[i] |= static_cast<uint32_t>(v);
+        if (i + 1 < size) shifted[i + 1] |= static_cast<uint32_t>(v >> 32);
+    }
+    return shifted;
+}
+
+// Long division (Knuth, TAOCP vol. 2, 4.3.1 Algorithm D) for a divisor of two or more limbs:
+// the divisor is normalized so its top bit is set, which keeps each estimated quotient
+// digit at most two above the true one.
+void divide_magnitude(const Limbs& a, const Limbs& b, Limbs& quotient, Limbs& remainder) {
+    if (compare_magnitude(a, b) < 0) {
+        quotient.clear();
+        remainder = a;
+        return;
+    }
+    if (b.size() == 1) {
+        uint32_t rest;
+        quotient = divide_small(a, b[0], rest);
+        remainder = rest ? Limbs{rest} : Limbs{};
+        return;
+    }
+
+    int bits = __builtin_clz(b.back());
+    Limbs u = shift_left(a, bits, a.size() + 1);
+    Limbs v = shift_left(b, bits, b.size());
+    const size_t n = v.size(), m = u.size() - n;
+    const uint64_t base = uint64_t(1) << 32;
+    quotient.assign(m, 0);
+
+    for (size_t j = m; j-- > 0;) {
+        uint64_t top = (uint64_t(u[j + n]) << 32) | u[j + n - 1];
+        uint64_t q = top / v[n - 1], r = top % v[n - 1];
+        while (q >= base || q * v[n - 2] > ((r << 32) | u[j + n - 2])) {
+            --q;
+            r += v[n - 1];
+            if (r >= base) break;
+        }
+
+        // u[j..j+n] -= q * v
+        int64_t borrow = 0;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t p = q * v[i] + carry;
+            carry = p >> 32;
+            int64_t t = int64_t(u[i + j]) - borrow - int64_t(p & 0xffffffffu);
+            u[i + j] = static_cast<uint32_t>(t);
+            borrow = t < 0 ? 1 : 0;
+        }
+        int64_t t = int64_t(u[j + n]) - borrow - int64_t(carry);
+        u[j + n] = static_cast<uint32_t>(t);
+
+        if (t < 0) { // q was one too large: add v back
+            --q;
+            uint64_t c = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t s = uint64_t(u[i + j]) + v[i] + c;
+                u[i + j] = static_cast<uint32_t>(s);
+                c = s >> 32;
+            }
+            u[j + n] += static_cast<uint32_t>(c);
+        }
+        quotient[j] = static_cast<uint32_t>(q);
+    }
+    trim(quotient);
+
+    remainder.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t v2 = (uint64_t(i + 1 < n ? u[i + 1] : 0) << 32) | u[i];
+        remainder[i] = static_cast<uint32_t>(v2 >> bits);
+    }
+    trim(remainder);
+}
+
+} // namespace
+
+BigInt::BigInt(int64_t value) {
+    negative_ = value < 0;
+    uint64_t magnitude = negative_ ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    while (magnitude != 0) {
+        limbs_.push_back(static_cast<uint32_t>(magnitude));
+        magnitude >>= 32;
+    }
+}
+
+BigInt BigInt::from_magnitude(Limbs limbs, bool negative) {
+    BigInt value;
+    trim(limbs);
+    value.limbs_ = std::move(limbs);
+    value.negative_ = negative && !value.limbs_.empty();
+    return value;
+}
+
+BigInt BigInt::power_of_two(unsigned k) {
+    Limbs limbs(k / 32 + 1, 0);
+    limbs.back() = uint32_t(1) << (k % 32);
+    return from_magnitude(std::move(limbs), false);
+}
+
+bool BigInt::fits_int64() const {
+    if (limbs_.size() > 2) return false;
+    uint64_t magnitude = 0;
+    for (size_t i = limbs_.size(); i-- > 0;) magnitude = (magnitude << 32) | limbs_[i];
+    return magnitude <= static_cast<uint64_t>(INT64_MAX);
+}
+
+int64_t BigInt::to_int64() const {
+    uint64_t magnitude = 0;
+    for (size_t i = limbs_.size(); i-- > 0;) magnitude = (magnitude << 32) | limbs_[i];
+    int64_t value = static_cast<int64_t>(magnitude);
+    return negative_ ? -value : value;
+}
+
+double BigInt::frexp(long& exponent) const {
+    exponent = 0;
+    if (is_zero()) return 0.0;
+    // The top three limbs carry more than the 53 bits a double keeps
+    double mantissa = 0.0;
+    size_t used = std::min<size_t>(3, limbs_.size());
+    for (size_t i = limbs_.size(); i-- > limbs_.size() - used;) mantissa = mantissa * 4294967296.0 + limbs_[i];
+    int e = 0;
+    mantissa = std::frexp(mantissa, &e);
+    exponent = e + 32L * static_cast<long>(limbs_.size() - used);
+    return negative_ ? -mantissa : mantissa;
+}
+
+double BigInt::to_double() const {
+    long exponent;
+    double mantissa = frexp(exponent);
+    if (exponent > 2000) return mantissa * HUGE_VAL; // Beyond ldexp's int range; keeps the sign
+    return std::ldexp(mantissa, static_cast<int>(exponent));
+}
+
+BigInt BigInt::operator-() const {
+    return from_magnitude(limbs_, !negative_);
+}
+
+BigInt BigInt::abs() const {
+    return from_magnitude(limbs_, false);
+}
+
+BigInt operator+(const BigInt& a, const BigInt& b) {
+    if (a.negative_ == b.negative_) return BigInt::from_magnitude(add_magnitude(a.limbs_, b.limbs_), a.negative_);
+    if (compare_magnitude(a.limbs_, b.limbs_) >= 0) {
+        return BigInt::from_magnitude(subtract_magnitude(a.limbs_, b.limbs_), a.negative_);
+    }
+    return BigInt::from_magnitude(subtract_magnitude(b.limbs_, a.limbs_), b.negative_);
+}
+
+BigInt operator-(const BigInt& a, const BigInt& b) {
+    return a + (-b);
+}
+
+BigInt operator*(const BigInt& a, const BigInt& b) {
+    return BigInt::from_magnitude(multiply_magnitude(a.limbs_, b.limbs_), a.negative_ != b.negative_);
+}
+
+void BigInt::divide(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder) {
+    if (b.is_zero()) throw std::domain_error("Integer division by zero.");
+    Limbs q, r;
+    divide_magnitude(a.limbs_, b.limbs_, q, r);
+    quotient = from_magnitude(std::move(q), a.negative_ != b.negative_);
+    remainder = from_magnitude(std::move(r), a.negative_);
+}
+
+BigInt operator/(const BigInt& a, const BigInt& b) {
+    BigInt quotient, remainder;
+    BigInt::divide(a, b, quotient, remainder);
+    return quotient;
+}
+
+BigInt operator%(const BigInt& a, const BigInt& b) {
+    BigInt quotient, remainder;
+    BigInt::divide(a, b, quotient, remainder);
+    return remainder;
+}
+
+BigInt BigInt::gcd(BigInt a, BigInt b) {
+    a.negative_ = false;
+    b.negative_ = false;
+    while (!b.is_zero()) {
+        BigInt r = a % b;
+        a = std::move(b);
+        b = std::move(r);
+    }
+    return a;
+}
+
+int BigInt::compare(const BigInt& a, const BigInt& b) {
+    if (a.negative_ != b.negative_) return a.negative_ ? -1 : 1;
+    int magnitude = compare_magnitude(a.limbs_, b.limbs_);
+    return a.negative_ ? -magnitude : magnitude;
+}
+
+void BigInt::append_to(std::string& out) const {
+    if (is_zero()) {
+        out += "0";
+        return;
+    }
+    // Nine decimal digits per division, least significant group first
+    std::vector<uint32_t> groups;
+    Limbs rest = limbs_;
+    while (!rest.empty()) {
+        uint32_t group;
+        rest = divide_small(rest, 1000000000u, group);
+        groups.push_back(group);
+    }
+    if (negative_) out += "-";
+    out += std::to_string(groups.back());
+    for (size_t i = groups.size() - 1; i-- > 0;) {
+        std::string digits = std::to_string(groups[i]);
+        out.append(9 - digits.size(), '0');
+        out += digits;
+    }
+}
+
+std::string BigInt::to_string() const {
+    std::string out;
+    append_to(out);
+    return out;
+}
+
+} // namespace Laplace
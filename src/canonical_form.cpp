@@ -0,0 +1,72 @@
+#include "../include/canonical_form.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace Laplace {
+
+namespace {
+
+// Fixed-size record per term; the key is these records back to back.
+struct CanonicalTerm {
+    double coefficient;
+    double parameters[TermParameters::capacity];
+    unsigned char type;
+    unsigned char parameter_count;
+};
+
+bool canonical_less(const CanonicalTerm& a, const CanonicalTerm& b) {
+    if (a.type != b.type) return a.type < b.type;
+    if (a.parameter_count != b.parameter_count) return a.parameter_count < b.parameter_count;
+    for (size_t i = 0; i < a.parameter_count; ++i) {
+        if (a.parameters[i] != b.parameters[i]) return a.parameters[i] < b.parameters[i];
+    }
+    return a.coefficient < b.coefficient;
+}
+
+// canonical_less needs a strict weak order, which a NaN breaks: 0*exp(t + 1000) has one.
+double finite(double value) {
+    if (!std::isfinite(value)) throw std::domain_error("Expression has a coefficient that is not a finite number.");
+    return value + 0.0; // Folds -0.0 into 0.0
+}
+
+} // namespace
+
+std::string canonical_key(const std::vector<ParsedTerm>& terms) {
+    std::vector<CanonicalTerm> records(terms.size());
+    for (size_t i = 0; i < terms.size(); ++i) {
+        CanonicalTerm& record = records[i];
+        std::memset(&record, 0, sizeof(record)); // Padding bytes take part in the key
+        record.coefficient = finite(terms[i].coefficient);
+        record.type = static_cast<unsigned char>(terms[i].type);
+        record.parameter_count = static_cast<unsigned char>(terms[i].parameters.size());
+        for (size_t p = 0; p < terms[i].parameters.size(); ++p) {
+            record.parameters[p] = finite(terms[i].parameters[p]);
+        }
+    }
+    std::sort(records.begin(), records.end(), canonical_less);
+
+    std::string key(records.size() * sizeof(CanonicalTerm), '\0');
+    if (!records.empty()) std::memcpy(&key[0], records.data(), key.size());
+    return key;
+}
+
+std::vector<ParsedTerm> decode_canonical_key(const std::string& key) {
+    if (key.size() % sizeof(CanonicalTerm) != 0) {
+        throw std::invalid_argument("Not a canonical expression key.");
+    }
+    std::vector<ParsedTerm> terms(key.size() / sizeof(CanonicalTerm));
+    for (size_t i = 0; i < terms.size(); ++i) {
+        CanonicalTerm record;
+        std::memcpy(&record, key.data() + i * sizeof(CanonicalTerm), sizeof(record));
+        terms[i].coefficient = record.coefficient;
+        terms[i].type = static_cast<FunctionType>(record.type);
+        for (size_t p = 0; p < record.parameter_count; ++p) {
+            terms[i].parameters.push_back(record.parameters[p]);
+        }
+    }
+    return terms;
+}
+
+} // namespace Laplace
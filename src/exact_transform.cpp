@@ -0,0 +1,298 @@
+#include "../include/exact_transform.h"
+#include "../include/transform_registry.h"
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+namespace Laplace {
+
+namespace {
+
+using ExactPolynomial = std::vector<Rational>;
+
+void trim(ExactPolynomial& p) {
+    while (p.size() > 1 && p.back().is_zero()) p.pop_back();
+    if (p.empty()) p.push_back(0);
+}
+
+bool is_zero(const ExactPolynomial& p) {
+    for (const Rational& c : p) {
+        if (!c.is_zero()) return false;
+    }
+    return true;
+}
+
+// Index of the only non-zero coefficient, or -1 if p has several (or none).
+int monomial_degree(const ExactPolynomial& p) {
+    int degree = -1;
+    for (size_t k = 0; k < p.size(); ++k) {
+        if (p[k].is_zero()) continue;
+        if (degree != -1) return -1;
+        degree = static_cast<int>(k);
+    }
+    return degree;
+}
+
+// A positive number that multiplies or divides: "3", or "(1/3)" so "(1/3)/s" cannot be
+// misread as 1/(3 s).
+void append_factor(std::string& out, const Rational& value) {
+    if (value.is_integer()) {
+        value.append_to(out);
+        return;
+    }
+    out += "(";
+    value.append_to(out);
+    out += ")";
+}
+
+// Writes the sign of value when negative, then the factor |value|.
+void append_signed_factor(std::string& out, const Rational& value) {
+    if (value.sign() < 0) out += "-";
+    append_factor(out, value.sign() < 0 ? -value : value);
+}
+
+// "s", "(s - 2)" or "(s + 1/3)"
+std::string variable_text(const Rational& shift) {
+    if (shift.is_zero()) return "s";
+    std::string text = "(s";
+    text += shift.sign() > 0 ? " - " : " + ";
+    (shift.sign() > 0 ? shift : -shift).append_to(text);
+    text += ")";
+    return text;
+}
+
+void append_power(std::string& out, const std::string& variable, int k) {
+    out += variable;
+    if (k > 1) {
+        out += "^";
+        out += std::to_string(k);
+    }
+}
+
+// Writes p(u) highest power first, e.g. "(s + 3)^2 + 9" or "s^2 + 1/4".
+void append_polynomial(std::string& out, const ExactPolynomial& p, const std::string& variable) {
+    bool first = true;
+    for (size_t k = p.size(); k-- > 0;) {
+        if (p[k].is_zero()) continue;
+        bool negative = p[k].sign() < 0;
+        if (first) {
+            if (negative) out += "-";
+        } else {
+            out += negative ? " - " : " + ";
+        }
+        first = false;
+        Rational c = negative ? -p[k] : p[k];
+        if (k == 0) {
+            c.append_to(out);
+            continue;
+        }
+        if (c != Rational(1)) {
+            append_factor(out, c);
+            out += "*";
+        }
+        append_power(out, variable, static_cast<int>(k));
+    }
+    if (first) out += "0";
+}
+
+ExactRationalFunction zero() {
+    ExactRationalFunction f;
+    f.numerator = {0};
+    f.denominator = {1};
+    return f;
+}
+
+// The exact form of transform_t_n_exp_osc for an integer n: coeff * n! * N(u) / D(u)^(n + 1),
+// with the binomial expansion of (u + i omega)^(n + 1) as the numerator.
+ExactRationalFunction exact_kernel(int n, const Rational& a, FunctionType oscillation, Rational omega,
+                                   const Rational& coeff) {
+    bool odd = oscillation == FunctionType::SIN || oscillation == FunctionType::SINH;
+    bool even = oscillation == FunctionType::COS || oscillation == FunctionType::COSH;
+    if (coeff.is_zero() || (odd && omega.is_zero())) return zero();
+    if (even && omega.is_zero()) oscillation = FunctionType::UNRECOGNIZED; // cos(0) = cosh(0) = 1
+
+    ExactRationalFunction f;
+    f.gain = coeff;
+    for (int k = 2; k <= n; ++k) f.gain *= k;
+    f.power = n + 1;
+    f.shift = a;
+    if (oscillation == FunctionType::UNRECOGNIZED) {
+        f.numerator = {1};
+        f.denominator = {0, 1};
+        return f;
+    }
+
+    bool trig = oscillation == FunctionType::SIN || oscillation == FunctionType::COS;
+    int m = f.power;
+    Rational omega_squared = omega * omega;
+    f.denominator = {trig ? omega_squared : -omega_squared, 0, 1};
+    f.numerator.assign(static_cast<size_t>(m + 1), 0);
+
+    // term = C(m,k) w^(m-k), from k = m down; j = m - k is the power of w (or of iw)
+    Rational term = 1;
+    for (int k = m; k >= 0; --k) {
+        int j = m - k;
+        if ((j % 2 == 1) == odd) {
+            bool negative = trig && (j / 2) % 2 == 1;
+            f.numerator[static_cast<size_t>(k)] = negative ? -term : term;
+        }
+        if (k > 0) term *= omega * Rational(k, j + 1);
+    }
+    if (odd) f.numerator.pop_back(); // The u^m coefficient has j = 0, never odd
+    return f;
+}
+
+ExactRationalFunction transform_with_coefficient(const ParsedTerm& term, const Rational& coeff) {
+    const FactorSignature& signature = checked_entry(term).signature;
+    size_t next = 0;
+
+    double n = signature.t_power == kAnyPower ? term.parameters[next++] : signature.t_power;
+    if (n != std::floor(n) || n < 0.0) {
+        throw std::domain_error("No exact transform for a non-integer power of t: Gamma(n + 1) is irrational.");
+    }
+    if (n > kMaxExactPower) throw std::invalid_argument("Power of t is too large for an exact transform.");
+    Rational a = signature.has_exp ? Rational::from_double(term.parameters[next++]) : Rational();
+    Rational omega;
+    if (signature.oscillation != FunctionType::UNRECOGNIZED) omega = Rational::from_double(term.parameters[next]);
+    return exact_kernel(static_cast<int>(n), a, signature.oscillation, omega, coeff);
+}
+
+} // namespace
+
+bool ExactRationalFunction::is_zero() const {
+    return gain.is_zero() || Laplace::is_zero(numerator);
+}
+
+std::string ExactRationalFunction::to_string() const {
+    std::string out;
+    append_to(out);
+    return out;
+}
+
+void ExactRationalFunction::append_to(std::string& out) const {
+    if (is_zero()) {
+        out += "0";
+        return;
+    }
+
+    std::string variable = variable_text(shift);
+
+    // Numerator: a single monomial absorbs the gain ("12*s", "-(1/3)/s"), anything longer
+    // keeps it as a factor ("3*(s^2 - 16)").
+    int k = monomial_degree(numerator);
+    if (k >= 0) {
+        Rational value = gain * numerator[static_cast<size_t>(k)];
+        if (k == 0) {
+            append_signed_factor(out, value);
+        } else {
+            if (value == Rational(-1)) out += "-";
+            else if (value != Rational(1)) {
+                append_signed_factor(out, value);
+                out += "*";
+            }
+            append_power(out, variable, k);
+        }
+    } else {
+        if (gain != Rational(1)) {
+            append_signed_factor(out, gain);
+            out += "*";
+        }
+        out += "(";
+        append_polynomial(out, numerator, variable);
+        out += ")";
+    }
+
+    // Denominator: "s^3", "(s - 2)", "((s - 2)^2)", "(s^2 + 4)", "(((s + 3)^2 + 9)^2)"
+    out += "/";
+    int d = monomial_degree(denominator);
+    if (d >= 0 && denominator[static_cast<size_t>(d)] == Rational(1)) {
+        int exponent = d * power;
+        if (shift.is_zero()) {
+            append_power(out, variable, exponent);
+        } else if (exponent == 1) {
+            out += variable;
+        } else {
+            out += "(";
+            append_power(out, variable, exponent);
+            out += ")";
+        }
+    } else if (power == 1) {
+        out += "(";
+        append_polynomial(out, denominator, variable);
+        out += ")";
+    } else {
+        out += "((";
+        append_polynomial(out, denominator, variable);
+        out += ")^";
+        out += std::to_string(power);
+        out += ")";
+    }
+}
+
+ExactRationalFunction exact_transform(const ParsedTerm& term) {
+    return transform_with_coefficient(term, Rational::from_double(term.coefficient));
+}
+
+std::vector<ExactRationalFunction> exact_transforms(const std::vector<ParsedTerm>& terms) {
+    // Like terms: same family and parameters, coefficients summed exactly, first-seen order
+    std::map<std::pair<FunctionType, std::vector<double>>, size_t> like_index;
+    std::vector<std::pair<const ParsedTerm*, Rational>> merged;
+    for (const ParsedTerm& term : terms) {
+        std::vector<double> parameters(term.parameters.begin(), term.parameters.end());
+        auto inserted = like_index.emplace(std::make_pair(term.type, std::move(parameters)), merged.size());
+        if (inserted.second) merged.emplace_back(&term, Rational());
+        merged[inserted.first->second].second += Rational::from_double(term.coefficient);
+    }
+
+    // Transforms over the same denominator, power and shift: one numerator, gain 1
+    std::map<std::tuple<int, Rational, ExactPolynomial>, size_t> group_index;
+    std::vector<std::vector<ExactRationalFunction>> groups;
+    for (const auto& entry : merged) {
+        if (entry.second.is_zero()) continue;
+        ExactRationalFunction f = transform_with_coefficient(*entry.first, entry.second);
+        if (f.is_zero()) continue;
+        auto inserted = group_index.emplace(std::make_tuple(f.power, f.shift, f.denominator), groups.size());
+        if (inserted.second) groups.emplace_back();
+        groups[inserted.first->second].push_back(std::move(f));
+    }
+
+    std::vector<ExactRationalFunction> result;
+    for (std::vector<ExactRationalFunction>& members : groups) {
+        if (members.size() == 1) {
+            // Alone over its denominator: keep the gain factored out, "3*(s^2 - 16)/..."
+            result.push_back(std::move(members[0]));
+            continue;
+        }
+        ExactRationalFunction sum = members[0];
+        sum.gain = 1;
+        sum.numerator.clear();
+        for (const ExactRationalFunction& f : members) {
+            if (sum.numerator.size() < f.numerator.size()) sum.numerator.resize(f.numerator.size());
+            for (size_t k = 0; k < f.numerator.size(); ++k) sum.numerator[k] += f.gain * f.numerator[k];
+        }
+        trim(sum.numerator);
+        if (!Laplace::is_zero(sum.numerator)) result.push_back(std::move(sum));
+    }
+
+    if (result.empty() && !terms.empty()) return {zero()};
+    return result;
+}
+
+void append_sum(std::string& out, const std::vector<ExactRationalFunction>& terms) {
+    for (size_t i = 0; i < terms.size(); ++i) {
+        if (i == 0) {
+            terms[i].append_to(out);
+            continue;
+        }
+        size_t separator = out.size();
+        out += " + ";
+        terms[i].append_to(out);
+        if (out[separator + 3] == '-') {
+            // The sign is already part of the term: " + -3/s" becomes " -3/s"
+            out.erase(separator + 1, 2);
+        }
+    }
+}
+
+} // namespace Laplace
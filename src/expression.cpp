@@ -0,0 +1,81 @@
+#include "../include/expression.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Laplace {
+
+namespace {
+
+uint64_t mix(uint64_t h, uint64_t value) {
+    h ^= value + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+uint64_t bits_of(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    return bits;
+}
+
+} // namespace
+
+void ExpressionDag::reset(size_t expected_nodes) {
+    nodes_.clear();
+    operands_.clear();
+    size_t slots = 16;
+    while (slots < 2 * expected_nodes) slots <<= 1;
+    slots_.assign(slots, kEmptySlot);
+}
+
+NodeId ExpressionDag::number(double value) {
+    return make(ExpressionKind::NUMBER, nullptr, 0, value + 0.0); // -0.0 and 0.0 are one node
+}
+
+NodeId ExpressionDag::power(NodeId base, NodeId exponent) {
+    NodeId operands[2] = {base, exponent};
+    return make(ExpressionKind::POWER, operands, 2);
+}
+
+NodeId ExpressionDag::combine(ExpressionKind kind, const NodeId* operands, size_t count) {
+    if (count == 1) return operands[0];
+    return make(kind, operands, count);
+}
+
+size_t ExpressionDag::hash(const ExpressionNode& node, const NodeId* operands) const {
+    uint64_t h = mix(static_cast<uint64_t>(node.kind), bits_of(node.value));
+    for (uint32_t i = 0; i < node.count; ++i) h = mix(h, operands[i]);
+    return static_cast<size_t>(h ^ (h >> 29));
+}
+
+NodeId ExpressionDag::make(ExpressionKind kind, const NodeId* operands, size_t count, double value) {
+    ExpressionNode candidate{kind, value, static_cast<uint32_t>(operands_.size()), static_cast<uint32_t>(count)};
+    const size_t mask = slots_.size() - 1;
+    for (size_t slot = hash(candidate, operands) & mask;; slot = (slot + 1) & mask) {
+        uint32_t id = slots_[slot];
+        if (id == kEmptySlot) {
+            id = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back(candidate);
+            operands_.insert(operands_.end(), operands, operands + count);
+            slots_[slot] = id;
+            if (2 * nodes_.size() > slots_.size()) grow();
+            return id;
+        }
+        const ExpressionNode& existing = nodes_[id];
+        if (existing.kind == kind && existing.count == candidate.count && bits_of(existing.value) == bits_of(value) &&
+            std::equal(operands, operands + count, operands_.begin() + existing.first)) {
+            return id;
+        }
+    }
+}
+
+void ExpressionDag::grow() {
+    slots_.assign(slots_.size() * 2, kEmptySlot);
+    const size_t mask = slots_.size() - 1;
+    for (uint32_t id = 0; id < nodes_.size(); ++id) {
+        size_t slot = hash(nodes_[id], operands(id)) & mask;
+        while (slots_[slot] != kEmptySlot) slot = (slot + 1) & mask;
+        slots_[slot] = id;
+    }
+}
+
+} // namespace Laplace
@@ -0,0 +1,291 @@
+#include "../include/frequency_response.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LAPLACE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace Laplace {
+
+namespace {
+
+using Term = FrequencyEvaluator::Term;
+
+const double kInfinity = std::numeric_limits<double>::infinity();
+
+// --- Scalar kernel, also used for the tail of the vector loops ---
+
+void evaluate_scalar(const Term* terms, size_t term_count, const double* c,
+                     const double* s_re, const double* s_im, size_t begin, size_t end,
+                     double* out_re, double* out_im) {
+    for (size_t i = begin; i < end; ++i) {
+        double acc_re = 0.0, acc_im = 0.0;
+        for (size_t t = 0; t < term_count; ++t) {
+            const Term& term = terms[t];
+            double u_re = s_re[i] - term.shift, u_im = s_im[i];
+
+            // N(u) by complex Horner
+            const double* n = c + term.numerator_offset;
+            double n_re = n[term.numerator_size - 1], n_im = 0.0;
+            for (size_t k = term.numerator_size - 1; k-- > 0;) {
+                double re = n_re * u_re - n_im * u_im + n[k];
+                n_im = n_re * u_im + n_im * u_re;
+                n_re = re;
+            }
+
+            // D(u) by complex Horner
+            const double* d = c + term.denominator_offset;
+            double d_re = d[term.denominator_size - 1], d_im = 0.0;
+            for (size_t k = term.denominator_size - 1; k-- > 0;) {
+                double re = d_re * u_re - d_im * u_im + d[k];
+                d_im = d_re * u_im + d_im * u_re;
+                d_re = re;
+            }
+
+            // Divide gain*N by D once per power. D is scaled to unit size first so neither
+            // |D|^2 nor the repeated quotient can underflow or overflow near a pole, and the
+            // two reciprocals are taken once so the power loop only multiplies.
+            double scale = std::max(std::fabs(d_re), std::fabs(d_im));
+            if (scale == 0.0) { // Exactly on a pole
+                acc_re += kInfinity;
+                continue;
+            }
+            double inv_scale = 1.0 / scale;
+            double c_re = d_re * inv_scale, c_im = d_im * inv_scale;
+            double inv_norm = 1.0 / ((c_re * c_re + c_im * c_im) * scale);
+            double q_re = term.gain * n_re, q_im = term.gain * n_im;
+            for (int p = 0; p < term.power; ++p) {
+                double re = (q_re * c_re + q_im * c_im) * inv_norm;
+                q_im = (q_im * c_re - q_re * c_im) * inv_norm;
+                q_re = re;
+            }
+            acc_re += q_re;
+            acc_im += q_im;
+        }
+        out_re[i] = acc_re;
+        out_im[i] = acc_im;
+    }
+}
+
+#ifdef LAPLACE_X86_SIMD
+
+// --- SSE2: two points per iteration ---
+
+__attribute__((target("sse2")))
+size_t evaluate_sse2(const Term* terms, size_t term_count, const double* c,
+                     const double* s_re, const double* s_im, size_t count,
+                     double* out_re, double* out_im) {
+    const __m128d sign_mask = _mm_set1_pd(-0.0);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d infinity = _mm_set1_pd(kInfinity);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d z_re = _mm_loadu_pd(s_re + i), z_im = _mm_loadu_pd(s_im + i);
+        __m128d acc_re = zero, acc_im = zero;
+        for (size_t t = 0; t < term_count; ++t) {
+            const Term& term = terms[t];
+            __m128d u_re = _mm_sub_pd(z_re, _mm_set1_pd(term.shift)), u_im = z_im;
+
+            const double* n = c + term.numerator_offset;
+            __m128d n_re = _mm_set1_pd(n[term.numerator_size - 1]), n_im = zero;
+            for (size_t k = term.numerator_size - 1; k-- > 0;) {
+                __m128d re = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(n_re, u_re), _mm_mul_pd(n_im, u_im)), _mm_set1_pd(n[k]));
+                n_im = _mm_add_pd(_mm_mul_pd(n_re, u_im), _mm_mul_pd(n_im, u_re));
+                n_re = re;
+            }
+
+            const double* d = c + term.denominator_offset;
+            __m128d d_re = _mm_set1_pd(d[term.denominator_size - 1]), d_im = zero;
+            for (size_t k = term.denominator_size - 1; k-- > 0;) {
+                __m128d re = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(d_re, u_re), _mm_mul_pd(d_im, u_im)), _mm_set1_pd(d[k]));
+                d_im = _mm_add_pd(_mm_mul_pd(d_re, u_im), _mm_mul_pd(d_im, u_re));
+                d_re = re;
+            }
+
+            __m128d scale = _mm_max_pd(_mm_andnot_pd(sign_mask, d_re), _mm_andnot_pd(sign_mask, d_im));
+            __m128d on_pole = _mm_cmpeq_pd(scale, zero);
+            scale = _mm_or_pd(_mm_and_pd(on_pole, _mm_set1_pd(1.0)), _mm_andnot_pd(on_pole, scale));
+            __m128d inv_scale = _mm_div_pd(_mm_set1_pd(1.0), scale);
+            __m128d c_re = _mm_mul_pd(d_re, inv_scale), c_im = _mm_mul_pd(d_im, inv_scale);
+            __m128d inv_norm = _mm_div_pd(_mm_set1_pd(1.0),
+                                          _mm_mul_pd(_mm_add_pd(_mm_mul_pd(c_re, c_re), _mm_mul_pd(c_im, c_im)), scale));
+            __m128d gain = _mm_set1_pd(term.gain);
+            __m128d q_re = _mm_mul_pd(gain, n_re), q_im = _mm_mul_pd(gain, n_im);
+            for (int p = 0; p < term.power; ++p) {
+                __m128d re = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(q_re, c_re), _mm_mul_pd(q_im, c_im)), inv_norm);
+                q_im = _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(q_im, c_re), _mm_mul_pd(q_re, c_im)), inv_norm);
+                q_re = re;
+            }
+            q_re = _mm_or_pd(_mm_and_pd(on_pole, infinity), _mm_andnot_pd(on_pole, q_re));
+            q_im = _mm_andnot_pd(on_pole, q_im);
+            acc_re = _mm_add_pd(acc_re, q_re);
+            acc_im = _mm_add_pd(acc_im, q_im);
+        }
+        _mm_storeu_pd(out_re + i, acc_re);
+        _mm_storeu_pd(out_im + i, acc_im);
+    }
+    return i;
+}
+
+// --- AVX2 + FMA: four points per iteration ---
+
+__attribute__((target("avx2,fma")))
+size_t evaluate_avx2(const Term* terms, size_t term_count, const double* c,
+                     const double* s_re, const double* s_im, size_t count,
+                     double* out_re, double* out_im) {
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d infinity = _mm256_set1_pd(kInfinity);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d z_re = _mm256_loadu_pd(s_re + i), z_im = _mm256_loadu_pd(s_im + i);
+        __m256d acc_re = zero, acc_im = zero;
+        for (size_t t = 0; t < term_count; ++t) {
+            const Term& term = terms[t];
+            __m256d u_re = _mm256_sub_pd(z_re, _mm256_set1_pd(term.shift)), u_im = z_im;
+
+            const double* n = c + term.numerator_offset;
+            __m256d n_re = _mm256_set1_pd(n[term.numerator_size - 1]), n_im = zero;
+            for (size_t k = term.numerator_size - 1; k-- > 0;) {
+                __m256d re = _mm256_fmadd_pd(n_re, u_re, _mm256_fnmadd_pd(n_im, u_im, _mm256_set1_pd(n[k])));
+                n_im = _mm256_fmadd_pd(n_re, u_im, _mm256_mul_pd(n_im, u_re));
+                n_re = re;
+            }
+
+            const double* d = c + term.denominator_offset;
+            __m256d d_re = _mm256_set1_pd(d[term.denominator_size - 1]), d_im = zero;
+            for (size_t k = term.denominator_size - 1; k-- > 0;) {
+                __m256d re = _mm256_fmadd_pd(d_re, u_re, _mm256_fnmadd_pd(d_im, u_im, _mm256_set1_pd(d[k])));
+                d_im = _mm256_fmadd_pd(d_re, u_im, _mm256_mul_pd(d_im, u_re));
+                d_re = re;
+            }
+
+            __m256d scale = _mm256_max_pd(_mm256_andnot_pd(sign_mask, d_re), _mm256_andnot_pd(sign_mask, d_im));
+            __m256d on_pole = _mm256_cmp_pd(scale, zero, _CMP_EQ_OQ);
+            scale = _mm256_blendv_pd(scale, one, on_pole);
+            __m256d inv_scale = _mm256_div_pd(one, scale);
+            __m256d c_re = _mm256_mul_pd(d_re, inv_scale), c_im = _mm256_mul_pd(d_im, inv_scale);
+            __m256d inv_norm = _mm256_div_pd(one, _mm256_mul_pd(_mm256_fmadd_pd(c_re, c_re, _mm256_mul_pd(c_im, c_im)), scale));
+            __m256d gain = _mm256_set1_pd(term.gain);
+            __m256d q_re = _mm256_mul_pd(gain, n_re), q_im = _mm256_mul_pd(gain, n_im);
+            for (int p = 0; p < term.power; ++p) {
+                __m256d re = _mm256_mul_pd(_mm256_fmadd_pd(q_re, c_re, _mm256_mul_pd(q_im, c_im)), inv_norm);
+                q_im = _mm256_mul_pd(_mm256_fmsub_pd(q_im, c_re, _mm256_mul_pd(q_re, c_im)), inv_norm);
+                q_re = re;
+            }
+            q_re = _mm256_blendv_pd(q_re, infinity, on_pole);
+            q_im = _mm256_blendv_pd(q_im, zero, on_pole);
+            acc_re = _mm256_add_pd(acc_re, q_re);
+            acc_im = _mm256_add_pd(acc_im, q_im);
+        }
+        _mm256_storeu_pd(out_re + i, acc_re);
+        _mm256_storeu_pd(out_im + i, acc_im);
+    }
+    return i;
+}
+
+#endif // LAPLACE_X86_SIMD
+
+} // namespace
+
+FrequencyEvaluator::FrequencyEvaluator(const std::vector<RationalFunction>& terms) : simd_(best_supported()) {
+    for (const RationalFunction& rf : terms) {
+        if (rf.is_zero()) continue;
+        if (!rf.is_rational() || rf.log_gain != 0.0) {
+            irregular_.push_back(rf);
+            continue;
+        }
+        Term term;
+        term.gain = rf.gain;
+        term.shift = rf.shift;
+        term.power = rf.power;
+        term.numerator_offset = coefficients_.size();
+        term.numerator_size = rf.numerator.size();
+        coefficients_.insert(coefficients_.end(), rf.numerator.begin(), rf.numerator.end());
+        term.denominator_offset = coefficients_.size();
+        term.denominator_size = rf.denominator.size();
+        coefficients_.insert(coefficients_.end(), rf.denominator.begin(), rf.denominator.end());
+        terms_.push_back(term);
+    }
+}
+
+FrequencyEvaluator::Simd FrequencyEvaluator::best_supported() {
+#ifdef LAPLACE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Simd::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Simd::SSE2;
+#endif
+    return Simd::Scalar;
+}
+
+void FrequencyEvaluator::force(Simd simd) {
+    simd_ = std::min(simd, best_supported());
+}
+
+const char* FrequencyEvaluator::name(Simd simd) {
+    switch (simd) {
+        case Simd::AVX2: return "avx2";
+        case Simd::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+void FrequencyEvaluator::evaluate(const double* s_re, const double* s_im, size_t count,
+                                  double* out_re, double* out_im) const {
+    const Term* terms = terms_.data();
+    const double* c = coefficients_.data();
+    size_t done = 0;
+#ifdef LAPLACE_X86_SIMD
+    if (simd_ == Simd::AVX2) {
+        done = evaluate_avx2(terms, terms_.size(), c, s_re, s_im, count, out_re, out_im);
+    } else if (simd_ == Simd::SSE2) {
+        done = evaluate_sse2(terms, terms_.size(), c, s_re, s_im, count, out_re, out_im);
+    }
+#endif
+    evaluate_scalar(terms, terms_.size(), c, s_re, s_im, done, count, out_re, out_im);
+    for (const RationalFunction& rf : irregular_) {
+        for (size_t i = 0; i < count; ++i) {
+            std::complex<double> value = rf.evaluate({s_re[i], s_im[i]});
+            out_re[i] += value.real();
+            out_im[i] += value.imag();
+        }
+    }
+}
+
+void FrequencyEvaluator::evaluate(const std::vector<std::complex<double>>& s,
+                                  std::vector<std::complex<double>>& out) const {
+    std::vector<double> s_re(s.size()), s_im(s.size()), out_re(s.size()), out_im(s.size());
+    for (size_t i = 0; i < s.size(); ++i) {
+        s_re[i] = s[i].real();
+        s_im[i] = s[i].imag();
+    }
+    evaluate(s_re.data(), s_im.data(), s.size(), out_re.data(), out_im.data());
+    out.resize(s.size());
+    for (size_t i = 0; i < s.size(); ++i) {
+        out[i] = {out_re[i], out_im[i]};
+    }
+}
+
+std::complex<double> FrequencyEvaluator::evaluate(std::complex<double> s) const {
+    double s_re = s.real(), s_im = s.imag(), out_re, out_im;
+    evaluate_scalar(terms_.data(), terms_.size(), coefficients_.data(), &s_re, &s_im, 0, 1, &out_re, &out_im);
+    std::complex<double> value(out_re, out_im);
+    for (const RationalFunction& rf : irregular_) value += rf.evaluate(s);
+    return value;
+}
+
+std::vector<std::complex<double>> log_frequency_grid(double w_min, double w_max, size_t n) {
+    std::vector<std::complex<double>> grid(n);
+    double log_min = std::log10(w_min), log_max = std::log10(w_max);
+    for (size_t i = 0; i < n; ++i) {
+        double fraction = n > 1 ? static_cast<double>(i) / static_cast<double>(n - 1) : 0.0;
+        grid[i] = {0.0, std::pow(10.0, log_min + fraction * (log_max - log_min))};
+    }
+    return grid;
+}
+
+} // namespace Laplace
@@ -0,0 +1,595 @@
+#include "../include/inverse_laplace.h"
+#include "../include/number_format.h"
+#include "../include/polynomial.h"
+#include "../include/special_functions.h"
+#include "../include/transform_registry.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace Laplace {
+
+namespace {
+
+using Complex = std::complex<double>;
+
+const double kEpsilon = std::numeric_limits<double>::epsilon();
+
+// --- Rational expressions in s, for the parser ---
+
+struct Rational {
+    Polynomial numerator;
+    Polynomial denominator;
+};
+
+Rational combine(const Rational& x, const Rational& y, double sign) {
+    // Same denominator (the common "a/(s+1) + b/(s+1)") adds numerators, so no spurious
+    // repeated poles are introduced
+    if (x.denominator == y.denominator) return {add(x.numerator, y.numerator, sign), x.denominator};
+    return {add(multiply(x.numerator, y.denominator), multiply(y.numerator, x.denominator), sign),
+            multiply(x.denominator, y.denominator)};
+}
+
+Rational product(const Rational& x, const Rational& y) {
+    return {multiply(x.numerator, y.numerator), multiply(x.denominator, y.denominator)};
+}
+
+Rational quotient(const Rational& x, const Rational& y) {
+    if (is_zero(y.numerator)) throw std::runtime_error("Division by zero in expression in s.");
+    return {multiply(x.numerator, y.denominator), multiply(x.denominator, y.numerator)};
+}
+
+Rational power(Rational base, int exponent) {
+    if (exponent < 0) {
+        if (is_zero(base.numerator)) throw std::runtime_error("Division by zero in expression in s.");
+        std::swap(base.numerator, base.denominator);
+        exponent = -exponent;
+    }
+    Rational result{{1.0}, {1.0}};
+    while (exponent > 0) {
+        if (exponent & 1) result = product(result, base);
+        exponent >>= 1;
+        if (exponent > 0) base = product(base, base);
+    }
+    return result;
+}
+
+// Recursive descent over the forward tokenizer's tokens:
+//   expression := term (('+' | '-') term)*
+//   term       := unary (('*' | '/') unary | factor)*    -- juxtaposition multiplies: "2s", "3(s+1)",
+//                                                        -- but not before a number: "2 3" is an error
+//   unary      := ('+' | '-') unary | factor
+//   factor     := primary ('^' integer)?
+//   primary    := NUMBER | 's' | 'pi' | '(' expression ')'
+// Signs and parentheses nest at most kMaxDepth deep, as in Parser, which bounds the recursion.
+class RationalParser {
+public:
+    explicit RationalParser(std::string_view input) {
+        tokenize(input, tokens_);
+    }
+
+    Rational parse() {
+        Rational result = expression();
+        if (current().type != TokenType::END_OF_INPUT) {
+            throw std::runtime_error("Unexpected token in expression in s: " + std::string(current().text));
+        }
+        return result;
+    }
+
+private:
+    static constexpr int kMaxDepth = 200;
+
+    std::vector<TokenView> tokens_; // Always ends with END_OF_INPUT
+    size_t index_ = 0;
+    int depth_ = 0;
+
+    const TokenView& current() const {
+        return tokens_[index_];
+    }
+
+    Rational expression() {
+        Rational result = term();
+        while (current().type == TokenType::PLUS || current().type == TokenType::MINUS) {
+            double sign = current().type == TokenType::PLUS ? 1.0 : -1.0;
+            ++index_;
+            result = combine(result, term(), sign);
+        }
+        return result;
+    }
+
+    Rational term() {
+        Rational result = unary();
+        for (;;) {
+            TokenType type = current().type;
+            if (type == TokenType::MULTIPLY) {
+                ++index_;
+                result = product(result, unary());
+            } else if (type == TokenType::DIVIDE) {
+                ++index_;
+                result = quotient(result, unary());
+            } else if (type == TokenType::IDENTIFIER || type == TokenType::LPAREN) {
+                result = product(result, factor());
+            } else {
+                return result;
+            }
+        }
+    }
+
+    Rational unary() {
+        if (current().type == TokenType::MINUS) {
+            ++index_;
+            enter();
+            Rational result = unary();
+            --depth_;
+            for (double& c : result.numerator) c = -c;
+            return result;
+        }
+        if (current().type == TokenType::PLUS) {
+            ++index_;
+            enter();
+            Rational result = unary();
+            --depth_;
+            return result;
+        }
+        return factor();
+    }
+
+    Rational factor() {
+        Rational base = primary();
+        if (current().type != TokenType::POWER) return base;
+        ++index_;
+        return power(base, integer_exponent());
+    }
+
+    // "3", "-2", "(3)" or "(-2)"
+    int integer_exponent() {
+        bool parenthesized = current().type == TokenType::LPAREN;
+        if (parenthesized) ++index_;
+        bool negative = current().type == TokenType::MINUS;
+        if (negative) ++index_;
+
+        const TokenView& token = current();
+        if (token.type != TokenType::NUMBER || token.value != std::floor(token.value) || token.value > 1000) {
+            throw std::runtime_error("Exponent in expression in s must be an integer: " + std::string(token.text));
+        }
+        ++index_;
+        if (parenthesized) expect(TokenType::RPAREN, ")");
+        int exponent = static_cast<int>(token.value);
+        return negative ? -exponent : exponent;
+    }
+
+    Rational primary() {
+        const TokenView& token = current();
+        switch (token.type) {
+            case TokenType::NUMBER:
+                ++index_;
+                return {{token.value}, {1.0}};
+            case TokenType::IDENTIFIER:
+                ++index_;
+                if (token.text == "s") return {{0.0, 1.0}, {1.0}};
+                if (token.text == "pi" || token.text == "PI") return {{M_PI}, {1.0}};
+                throw std::runtime_error("Unknown identifier in expression in s: " + std::string(token.text));
+            case TokenType::LPAREN: {
+                ++index_;
+                enter();
+                Rational inner = expression();
+                --depth_;
+                expect(TokenType::RPAREN, ")");
+                return inner;
+            }
+            case TokenType::END_OF_INPUT:
+                throw std::runtime_error("Unexpected end of expression in s.");
+            default:
+                throw std::runtime_error("Unexpected token in expression in s: " + std::string(token.text));
+        }
+    }
+
+    void enter() {
+        if (++depth_ > kMaxDepth) throw std::runtime_error("Expression in s is nested too deeply.");
+    }
+
+    void expect(TokenType type, const char* text) {
+        if (current().type != type) {
+            throw std::runtime_error(std::string("Expected '") + text + "' in expression in s.");
+        }
+        ++index_;
+    }
+};
+
+// --- Root finding ---
+
+// Horner's rounding error bound for p at |z|: sum |p_k| |z|^k.
+double evaluation_bound(const Polynomial& p, double magnitude) {
+    double bound = 0.0;
+    for (size_t k = p.size(); k-- > 0;) {
+        bound = bound * magnitude + std::fabs(p[k]);
+    }
+    return bound;
+}
+
+struct NewtonRatio {
+    Complex ratio;   // p(z) / p'(z)
+    bool negligible; // |p(z)| is within rounding error, so z is as good as it gets
+};
+
+// For |z| > 1 this goes through the reversed polynomial, so high powers of z cannot overflow:
+// p(z) = z^n q(1/z), which gives p/p' = z q / (n q - q'/z).
+NewtonRatio newton_ratio(const Polynomial& p, Complex z) {
+    size_t n = p.size() - 1;
+    double noise = 8.0 * static_cast<double>(n) * kEpsilon;
+    if (std::abs(z) <= 1.0) {
+        Complex value = p[n], derivative = 0.0;
+        for (size_t k = n; k-- > 0;) {
+            derivative = derivative * z + value;
+            value = value * z + p[k];
+        }
+        return {value / derivative, std::abs(value) <= noise * evaluation_bound(p, std::abs(z))};
+    }
+
+    Complex y = 1.0 / z;
+    Complex value = p[0], derivative = 0.0;
+    double bound = std::fabs(p[0]);
+    for (size_t k = 1; k <= n; ++k) {
+        derivative = derivative * y + value;
+        value = value * y + p[k];
+        bound = bound * std::abs(y) + std::fabs(p[k]);
+    }
+    return {z * value / (static_cast<double>(n) * value - y * derivative), std::abs(value) <= noise * bound};
+}
+
+// All roots of a monic p with p(0) != 0, by Aberth-Ehrlich iteration (Gauss-Seidel style).
+// Starting points sit on a circle about the mean of the roots with a radius equal to the
+// geometric mean of their distance from it, |p(center)|^(1/n).
+std::vector<Complex> aberth_roots(const Polynomial& p) {
+    size_t n = p.size() - 1;
+    double center = -p[n - 1] / static_cast<double>(n);
+    double at_center = 0.0;
+    for (size_t k = p.size(); k-- > 0;) {
+        at_center = at_center * center + p[k];
+    }
+    double radius = std::pow(std::fabs(at_center), 1.0 / static_cast<double>(n));
+    if (!(radius > 0.0) || !std::isfinite(radius)) radius = 1.0;
+
+    std::vector<Complex> z(n);
+    for (size_t i = 0; i < n; ++i) {
+        double angle = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n) + 0.4; // Off the real axis
+        z[i] = center + std::polar(radius, angle);
+    }
+
+    std::vector<char> done(n, 0);
+    size_t remaining = n;
+    for (int iteration = 0; iteration < 1000 && remaining > 0; ++iteration) {
+        for (size_t i = 0; i < n; ++i) {
+            if (done[i]) continue;
+            NewtonRatio newton = newton_ratio(p, z[i]);
+            if (newton.negligible) {
+                done[i] = 1;
+                --remaining;
+                continue;
+            }
+            Complex repulsion = 0.0;
+            for (size_t j = 0; j < n; ++j) {
+                if (j != i) repulsion += 1.0 / (z[i] - z[j]);
+            }
+            Complex step = newton.ratio / (1.0 - newton.ratio * repulsion);
+            if (!std::isfinite(step.real()) || !std::isfinite(step.imag())) continue;
+            z[i] -= step;
+            if (std::abs(step) <= kEpsilon * std::abs(z[i])) {
+                done[i] = 1;
+                --remaining;
+            }
+        }
+    }
+    return z;
+}
+
+// t[j] = p^(j)(c) / j! for j <= order, by repeated synthetic division by (s - c).
+std::vector<Complex> taylor_coefficients(const Polynomial& p, Complex c, size_t order) {
+    std::vector<Complex> b(p.begin(), p.end());
+    std::vector<Complex> t(order + 1, 0.0);
+    for (size_t j = 0; j <= order && j < b.size(); ++j) {
+        for (size_t k = b.size() - 1; k > j; --k) {
+            b[k - 1] += c * b[k];
+        }
+        t[j] = b[j];
+    }
+    return t;
+}
+
+struct Cluster {
+    Complex center;
+    double extent;     // How far the members and their inclusion discs reach from the center
+    bool crosses_axis; // Some member's disc meets the real axis
+    int multiplicity;
+};
+
+// Groups the computed roots into poles with inclusion discs: each z_i gets the radius
+// n |W_i|, where W_i = (|p(z_i)| + rounding noise) / prod |z_i - z_j| is its Weierstrass
+// correction. A connected group of m overlapping discs holds exactly m roots of a polynomial
+// within rounding of p, so a group of several is one repeated root as far as double precision
+// can tell. Its center is the mean, polished by Newton on p^(m-1), of which it is a simple root.
+std::vector<Cluster> cluster_roots(const Polynomial& p, const std::vector<Complex>& roots) {
+    size_t n = roots.size();
+    double noise = 8.0 * static_cast<double>(n) * kEpsilon;
+    std::vector<double> radius(n);
+    for (size_t i = 0; i < n; ++i) {
+        Complex value = 0.0;
+        for (size_t k = p.size(); k-- > 0;) value = value * roots[i] + p[k];
+        double log_radius = std::log(std::abs(value) + noise * evaluation_bound(p, std::abs(roots[i])));
+        for (size_t j = 0; j < n; ++j) {
+            if (j != i) log_radius -= std::log(std::abs(roots[i] - roots[j]));
+        }
+        radius[i] = static_cast<double>(n) * std::exp(log_radius);
+    }
+
+    // Connected components of overlapping discs
+    std::vector<size_t> parent(n);
+    for (size_t i = 0; i < n; ++i) parent[i] = i;
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            if (std::abs(roots[i] - roots[j]) <= radius[i] + radius[j]) parent[find(i)] = find(j);
+        }
+    }
+
+    std::vector<Cluster> clusters;
+    std::vector<size_t> cluster_of(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t root = find(i);
+        if (cluster_of[root] == n) {
+            cluster_of[root] = clusters.size();
+            clusters.push_back({0.0, 0.0, false, 0});
+        }
+        Cluster& cluster = clusters[cluster_of[root]];
+        cluster.center += roots[i];
+        cluster.multiplicity += 1;
+        cluster.crosses_axis = cluster.crosses_axis || std::fabs(roots[i].imag()) <= radius[i];
+    }
+    for (Cluster& cluster : clusters) cluster.center /= static_cast<double>(cluster.multiplicity);
+    for (size_t i = 0; i < n; ++i) {
+        Cluster& cluster = clusters[cluster_of[find(i)]];
+        cluster.extent = std::max(cluster.extent, std::abs(roots[i] - cluster.center) + radius[i]);
+    }
+
+    for (Cluster& cluster : clusters) {
+        if (cluster.multiplicity == 1) continue;
+        size_t m = static_cast<size_t>(cluster.multiplicity);
+        Complex center = cluster.center;
+        for (int iteration = 0; iteration < 20; ++iteration) {
+            std::vector<Complex> t = taylor_coefficients(p, center, m);
+            if (t[m] == 0.0) break;
+            Complex step = t[m - 1] / (static_cast<double>(m) * t[m]);
+            center -= step;
+            if (!(std::abs(center - cluster.center) <= cluster.extent)) break; // Left the group
+            if (std::abs(step) <= kEpsilon * std::max(1.0, std::abs(center))) break;
+        }
+        if (std::abs(center - cluster.center) <= cluster.extent) cluster.center = center;
+    }
+    return clusters;
+}
+
+// Makes complex poles exact conjugate pairs: a group whose discs meet the real axis is its own
+// mirror image, so it is real; any other pairs with the closest group on the other side.
+// Poles that end up at the same place are merged.
+std::vector<Pole> pair_conjugates(std::vector<Cluster> clusters) {
+    for (Cluster& cluster : clusters) {
+        if (cluster.crosses_axis) cluster.center.imag(0.0);
+        if (std::fabs(cluster.center.real()) <= 1e-12 * std::abs(cluster.center)) cluster.center.real(0.0);
+    }
+
+    std::vector<Pole> poles;
+    std::vector<char> used(clusters.size(), 0);
+    for (size_t i = 0; i < clusters.size(); ++i) {
+        if (used[i]) continue;
+        const Cluster& upper = clusters[i];
+        used[i] = 1;
+        if (upper.center.imag() == 0.0) {
+            poles.push_back({upper.center, upper.multiplicity});
+            continue;
+        }
+
+        // Partner: the unused group on the other side closest to the conjugate
+        size_t partner = clusters.size();
+        double distance = INFINITY;
+        for (size_t j = i + 1; j < clusters.size(); ++j) {
+            if (used[j] || clusters[j].multiplicity != upper.multiplicity) continue;
+            if ((clusters[j].center.imag() > 0.0) == (upper.center.imag() > 0.0)) continue;
+            double d = std::abs(clusters[j].center - std::conj(upper.center));
+            if (d < distance) {
+                distance = d;
+                partner = j;
+            }
+        }
+        if (partner == clusters.size()) {
+            // Rounding split a real group unevenly; it can only be real
+            poles.push_back({upper.center.real(), upper.multiplicity});
+            continue;
+        }
+        used[partner] = 1;
+
+        Complex mean = 0.5 * (upper.center + std::conj(clusters[partner].center));
+        if (mean.imag() < 0.0) mean = std::conj(mean);
+        poles.push_back({mean, upper.multiplicity});
+        poles.push_back({std::conj(mean), upper.multiplicity});
+    }
+
+    std::sort(poles.begin(), poles.end(), [](const Pole& a, const Pole& b) {
+        if (a.location.real() != b.location.real()) return a.location.real() > b.location.real();
+        return a.location.imag() > b.location.imag();
+    });
+    std::vector<Pole> merged;
+    for (const Pole& pole : poles) {
+        if (!merged.empty() && merged.back().location == pole.location) {
+            merged.back().multiplicity += pole.multiplicity;
+        } else {
+            merged.push_back(pole);
+        }
+    }
+    return merged;
+}
+
+// --- Formatting ---
+
+// Six significant digits: the coefficients come from numerical root finding, and
+// shortest round-trip text would print its rounding noise ("0.49999999999999994").
+std::string number_text(double value) {
+    std::string text;
+    append_number(text, value, {NumberStyle::General, 6});
+    return text;
+}
+
+// "t", "-t" or "2.5*t"
+std::string times_t(double value) {
+    std::string text = number_text(value);
+    if (text == "1") return "t";
+    if (text == "-1") return "-t";
+    return text + "*t";
+}
+
+} // namespace
+
+FunctionType TimeTerm::family() const {
+    const TransformEntry* entry = find_product_family(t_power, a != 0.0, oscillation);
+    return entry ? entry->type : FunctionType::UNKNOWN_COMPOUND;
+}
+
+std::string TimeTerm::to_string() const {
+    std::string factors;
+    auto append = [&factors](const std::string& factor) {
+        if (!factors.empty()) factors += "*";
+        factors += factor;
+    };
+    if (t_power == 1) append("t");
+    if (t_power > 1) append("t^" + std::to_string(t_power));
+    if (a != 0.0) append("e^(" + times_t(a) + ")");
+    if (oscillation == FunctionType::SIN) append("sin(" + times_t(omega) + ")");
+    if (oscillation == FunctionType::COS) append("cos(" + times_t(omega) + ")");
+
+    std::string coefficient_text = number_text(coefficient);
+    if (factors.empty()) return coefficient_text;
+    if (coefficient_text == "1") return factors;
+    if (coefficient_text == "-1") return "-" + factors;
+    return coefficient_text + "*" + factors;
+}
+
+std::vector<Pole> find_poles(const std::vector<double>& polynomial) {
+    Polynomial p = polynomial;
+    trim(p);
+    if (p.size() < 2) throw std::runtime_error("A constant has no poles.");
+
+    double leading = p.back();
+    for (double& c : p) c /= leading;
+
+    // Roots at zero are exact; take them out before iterating
+    size_t zeros = 0;
+    while (p[zeros] == 0.0) ++zeros;
+    p.erase(p.begin(), p.begin() + static_cast<std::ptrdiff_t>(zeros));
+
+    std::vector<Cluster> clusters;
+    if (p.size() > 1) clusters = cluster_roots(p, aberth_roots(p));
+    if (zeros > 0) clusters.push_back({0.0, 0.0, true, static_cast<int>(zeros)});
+    return pair_conjugates(clusters);
+}
+
+std::vector<TimeTerm> inverse_laplace(const std::vector<double>& numerator, const std::vector<double>& denominator) {
+    Polynomial n = numerator.empty() ? Polynomial{0.0} : numerator;
+    Polynomial d = denominator.empty() ? Polynomial{0.0} : denominator;
+    trim(n);
+    trim(d);
+    if (is_zero(d)) throw std::runtime_error("Denominator is zero.");
+    if (is_zero(n)) return {};
+    if (n.size() >= d.size()) {
+        throw std::runtime_error("Inverse transform needs the numerator degree (" + std::to_string(n.size() - 1) +
+                                 ") below the denominator degree (" + std::to_string(d.size() - 1) + ").");
+    }
+
+    double leading = d.back();
+    for (double& c : n) c /= leading;
+    std::vector<Pole> poles = find_poles(d);
+
+    // For a pole p of multiplicity m, F = N / ((s - p)^m Q). With G = N / Q expanded about p,
+    // G = sum g_k (s - p)^k, the partial fractions are g_k / (s - p)^(m - k), whose inverse is
+    // g_k t^(m-k-1) e^(p t) / (m-k-1)!. A conjugate pair adds up to 2 Re(... ), i.e. cos and sin.
+    std::vector<TimeTerm> terms;
+    for (size_t i = 0; i < poles.size(); ++i) {
+        const Pole& pole = poles[i];
+        if (pole.location.imag() < 0.0) continue; // Covered by its conjugate
+        size_t m = static_cast<size_t>(pole.multiplicity);
+
+        std::vector<Complex> q(m, 0.0);
+        q[0] = 1.0;
+        for (size_t j = 0; j < poles.size(); ++j) {
+            if (j == i) continue;
+            // Multiply by ((p - p_j) + u)^(m_j), truncated after u^(m-1)
+            Complex offset = pole.location - poles[j].location;
+            for (int r = 0; r < poles[j].multiplicity; ++r) {
+                for (size_t k = m; k-- > 0;) {
+                    q[k] = q[k] * offset + (k > 0 ? q[k - 1] : Complex(0.0));
+                }
+            }
+        }
+
+        std::vector<Complex> num = taylor_coefficients(n, pole.location, m - 1);
+        std::vector<Complex> g(m);
+        for (size_t k = 0; k < m; ++k) {
+            Complex value = num[k];
+            for (size_t r = 1; r <= k; ++r) value -= q[r] * g[k - r];
+            g[k] = value / q[0];
+        }
+
+        for (size_t k = m; k-- > 0;) {
+            int t_power = static_cast<int>(m - 1 - k);
+            double scale = 1.0 / factorial(t_power);
+            double a = pole.location.real();
+            if (pole.location.imag() == 0.0) {
+                terms.push_back({g[k].real() * scale, t_power, a, FunctionType::UNRECOGNIZED, 0.0});
+            } else {
+                double omega = pole.location.imag();
+                terms.push_back({2.0 * g[k].real() * scale, t_power, a, FunctionType::COS, omega});
+                terms.push_back({-2.0 * g[k].imag() * scale, t_power, a, FunctionType::SIN, omega});
+            }
+        }
+    }
+
+    // Drop what is only rounding left over from cancelling residues
+    double largest = 0.0;
+    for (const TimeTerm& term : terms) largest = std::max(largest, std::fabs(term.coefficient));
+    terms.erase(std::remove_if(terms.begin(), terms.end(), [largest](const TimeTerm& term) {
+        return std::fabs(term.coefficient) <= 1e-10 * largest;
+    }), terms.end());
+    return terms;
+}
+
+void parse_rational(std::string_view expression, std::vector<double>& numerator, std::vector<double>& denominator) {
+    Rational result = RationalParser(expression).parse();
+    numerator = std::move(result.numerator);
+    denominator = std::move(result.denominator);
+}
+
+std::vector<TimeTerm> inverse_laplace(std::string_view expression) {
+    std::vector<double> numerator, denominator;
+    parse_rational(expression, numerator, denominator);
+    return inverse_laplace(numerator, denominator);
+}
+
+std::string to_string(const std::vector<TimeTerm>& terms) {
+    if (terms.empty()) return "0";
+    std::string total;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        std::string term = terms[i].to_string();
+        if (i == 0) {
+            total = term;
+        } else if (term[0] == '-') {
+            total += " - " + term.substr(1);
+        } else {
+            total += " + " + term;
+        }
+    }
+    return total;
+}
+
+} // namespace Laplace
@@ -1,22 +1,14 @@
 #include <../include/laplace_transforms.h>
+#include <../include/constexpr_laplace.h> // The coefficient math itself
+#include <../include/special_functions.h>
 #include <string>
 #include <vector>
 #include <stdexcept> // For exceptions
 #include <cmath>     
-#include <sstream>   // For string formatting
-#include <iomanip>   
 #include <iostream>
 
 double factorial(int n) {
-    if (n < 0) {
-        throw std::invalid_argument("Factorial is not defined for negative integers.");
-    }
-    
-    double res = 1.0;
-    for (int i = 1; i <= n; ++i) {
-        res *= i;
-    }
-    return res;
+    return Laplace::factorial(n);
 }
 
 // Namespace for Laplace Transform functions
@@ -26,13 +18,10 @@ namespace Laplace {
  * @brief Computes the Laplace Transform of a constant c.
  * L{c} = c/s
  * @param c The constant value.
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_constant(double c) {
-    if (c == 0.0) return "0";
-    std::ostringstream oss;
-    oss << c << "/s";
-    return oss.str();
+RationalFunction transform_constant(double c) {
+    return ct::transform_constant(c).to_runtime();
 }
 
 /**
@@ -40,31 +29,27 @@ std::string transform_constant(double c) {
  * L{coeff * t^n} = coeff * n! / s^(n+1)
  * @param n The exponent (non-negative integer).
  * @param coeff The coefficient multiplying t^n (default is 1.0).
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_t_pow_n(int n, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (n < 0) throw std::invalid_argument("n must be a non-negative integer for L{t^n}.");
-
-    std::ostringstream oss;
-    double fact_n = factorial(n);
-    double total_coeff = coeff * fact_n;
-
-    if (total_coeff == 0.0) {
-        return "0";
-    }
+RationalFunction transform_t_pow_n(int n, double coeff) {
+    // n! past the table only fits in log form, which the compile-time table cannot hold
+    if (n > kMaxFactorial) return transform_t_n_exp_osc(n, 0.0, FunctionType::UNRECOGNIZED, 0.0, coeff);
+    // L{coeff*t^0} = L{coeff} = coeff/s falls out of the same form
+    return ct::transform_t_pow_n(n, coeff).to_runtime();
+}
 
-    // Simplification logic for 1/s^n+1 vs coeff/s^n+1
-    if (n == 0) { // L{coeff*t^0} = L{coeff} = coeff/s
-        oss << total_coeff << "/s";
-    } else {
-        if (total_coeff == 1.0) {
-            oss << "1/s^" << (n + 1);
-        } else {
-            oss << total_coeff << "/s^" << (n + 1);
-        }
+/**
+ * @brief Computes the Laplace Transform of t^nu for a real exponent.
+ * L{coeff * t^nu} = coeff * Gamma(nu+1) / s^(nu+1), nu > -1
+ * @param nu The exponent; integers go through transform_t_pow_n.
+ * @param coeff The coefficient multiplying t^nu (default is 1.0).
+ * @return The transform, with a fractional power of s unless nu is an integer.
+ */
+RationalFunction transform_t_pow(double nu, double coeff) {
+    if (nu >= 0.0 && nu <= kMaxFactorial && nu == std::floor(nu)) {
+        return transform_t_pow_n(static_cast<int>(nu), coeff);
     }
-    return oss.str();
+    return transform_t_n_exp_osc(nu, 0.0, FunctionType::UNRECOGNIZED, 0.0, coeff);
 }
 
 
@@ -73,19 +58,10 @@ std::string transform_t_pow_n(int n, double coeff) {
  * L{coeff * e^(at)} = coeff / (s - a)
  * @param a The constant in the exponent.
  * @param coeff The coefficient multiplying e^(at) (default is 1.0).
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_exp(double a, double coeff) {
-    if (coeff == 0.0) return "0";
-    std::ostringstream oss;
-    oss << coeff;
-    oss << "/(s";
-    if (a != 0.0) {
-        if (a > 0.0) oss << " - " << a;
-        else oss << " + " << -a;
-    }
-    oss << ")";
-    return oss.str();
+RationalFunction transform_exp(double a, double coeff) {
+    return ct::transform_exp(a, coeff).to_runtime();
 }
 
 /**
@@ -93,16 +69,10 @@ std::string transform_exp(double a, double coeff) {
  * L{coeff * sin(omega*t)} = coeff * omega / (s^2 + omega^2)
  * @param omega The angular frequency.
  * @param coeff The coefficient multiplying sin(omega*t) (default is 1.0).
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_sin(double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return "0"; // sin(0) = 0
-
-    std::ostringstream oss;
-    oss << coeff * omega;
-    oss << "/(s^2 + " << omega * omega << ")";
-    return oss.str();
+RationalFunction transform_sin(double omega, double coeff) {
+    return ct::transform_sin(omega, coeff).to_runtime();
 }
 
 /**
@@ -110,17 +80,10 @@ std::string transform_sin(double omega, double coeff) {
  * L{coeff * cos(omega*t)} = coeff * s / (s^2 + omega^2)
  * @param omega The angular frequency.
  * @param coeff The coefficient multiplying cos(omega*t) (default is 1.0).
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_cos(double omega, double coeff ) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return transform_constant(coeff); // cos(0) = 1, so L{coeff*1}
-
-    std::ostringstream oss;
-    if (coeff != 1.0) oss << coeff << "*";
-    oss << "s";
-    oss << "/(s^2 + " << omega * omega << ")";
-    return oss.str();
+RationalFunction transform_cos(double omega, double coeff ) {
+    return ct::transform_cos(omega, coeff).to_runtime();
 }
 
 // --- More Advanced/Combined Forms (using properties) ---
@@ -128,93 +91,39 @@ std::string transform_cos(double omega, double coeff ) {
 /**
  * @brief L{coeff * t * e^(at)} = coeff / (s-a)^2
  */
-std::string transform_t_exp(double a, double coeff ) {
-    if (coeff == 0.0) return "0";
-    std::ostringstream oss;
-    oss << coeff; // The formula is 1/(s-a)^2, so coeff goes to numerator
-    oss << "/((s";
-    if (a != 0.0) {
-        if (a > 0.0) oss << " - " << a;
-        else oss << " + " << -a;
-    }
-    oss << ")^2)";
-    return oss.str();
+RationalFunction transform_t_exp(double a, double coeff ) {
+    return ct::transform_t_exp(a, coeff).to_runtime();
 }
 
 /**
  * @brief L{coeff * t * sin(omega*t)} = coeff * 2*omega*s / (s^2 + omega^2)^2
  */
-std::string transform_t_sin(double omega, double coeff ) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return "0"; // t*sin(0) = 0
-    std::ostringstream oss;
+RationalFunction transform_t_sin(double omega, double coeff ) {
     // L{t*sin(wt)} = -d/ds(w/(s^2+w^2)) = - (0 - w*2s) / (s^2+w^2)^2 = 2ws / (s^2+w^2)^2
-    oss << coeff * 2.0 * omega << "*s";
-    oss << "/((s^2 + " << omega * omega << ")^2)";
-    return oss.str();
+    return ct::transform_t_sin(omega, coeff).to_runtime();
 }
 
 /**
  * @brief L{coeff * t * cos(omega*t)} = coeff * (s^2 - omega^2) / (s^2 + omega^2)^2
  */
-std::string transform_t_cos(double omega, double coeff ) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return transform_t_pow_n(1, coeff); // t*cos(0) = t
-
-    std::ostringstream oss;
+RationalFunction transform_t_cos(double omega, double coeff ) {
     // L{t*cos(wt)} = -d/ds(s/(s^2+w^2)) = - (1*(s^2+w^2) - s*2s) / (s^2+w^2)^2
     // = - (s^2+w^2 - 2s^2) / (s^2+w^2)^2 = - (w^2 - s^2) / (s^2+w^2)^2 = (s^2 - w^2) / (s^2+w^2)^2
-    if (coeff != 1.0) oss << coeff << "*";
-    oss << "(s^2 - " << omega * omega << ")";
-    oss << "/((s^2 + " << omega * omega << ")^2)";
-    return oss.str();
+    return ct::transform_t_cos(omega, coeff).to_runtime();
 }
 
 /**
  * @brief L{coeff * e^(at) * sin(omega*t)} = coeff * omega / ((s-a)^2 + omega^2)
  */
-std::string transform_exp_sin(double a, double omega, double coeff ) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return "0"; // e^(at)*sin(0) = 0
-
-    std::ostringstream oss;
-    oss << coeff * omega;
-    oss << "/((s";
-    if (a != 0.0) {
-        if (a > 0.0) oss << " - " << a;
-        else oss << " + " << -a;
-    }
-    oss << ")^2 + " << (omega * omega) << ")";
-    return oss.str();
+RationalFunction transform_exp_sin(double a, double omega, double coeff ) {
+    return ct::transform_exp_sin(a, omega, coeff).to_runtime();
 }
 
 /**
  * @brief L{coeff * e^(at) * cos(omega*t)} = coeff * (s-a) / ((s-a)^2 + omega^2)
  */
-std::string transform_exp_cos(double a, double omega, double coeff ) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return transform_exp(a, coeff); // e^(at)*cos(0) = e^(at)
-
-    std::ostringstream oss;
-    if (coeff != 1.0) { // If coeff is 1, it will be (s-a)/...
-        oss << coeff << "*(s";
-        if (a > 0.0) oss << " - " << a;
-        else if (a < 0.0) oss << " + " << -a;
-        oss << ")";
-    } else { // coeff is 1
-        oss << "(s";
-        if (a > 0.0) oss << " - " << a;
-        else if (a < 0.0) oss << " + " << -a;
-        oss << ")";
-    }
-
-    oss << "/((s";
-    if (a != 0.0) {
-        if (a > 0.0) oss << " - " << a;
-        else oss << " + " << -a;
-    }
-    oss << ")^2 + " << (omega * omega) << ")";
-    return oss.str();
+RationalFunction transform_exp_cos(double a, double omega, double coeff ) {
+    return ct::transform_exp_cos(a, omega, coeff).to_runtime();
 }
 
 /**
@@ -222,16 +131,10 @@ std::string transform_exp_cos(double a, double omega, double coeff ) {
  * L{coeff * sinh(omega*t)} = coeff * omega / (s^2 - omega^2)
  * @param omega The angular frequency.
  * @param coeff The coefficient multiplying sinh(omega*t).
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_sinh(double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return "0"; // sinh(0) = 0
-
-    std::ostringstream oss;
-    oss << coeff * omega;
-    oss << "/(s^2 - " << omega * omega << ")";
-    return oss.str();
+RationalFunction transform_sinh(double omega, double coeff) {
+    return ct::transform_sinh(omega, coeff).to_runtime();
 }
 
 /**
@@ -239,53 +142,33 @@ std::string transform_sinh(double omega, double coeff) {
  * L{coeff * cosh(omega*t)} = coeff * s / (s^2 - omega^2)
  * @param omega The angular frequency.
  * @param coeff The coefficient multiplying cosh(omega*t).
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_cosh(double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return Laplace::transform_constant(coeff); // cosh(0) = 1, so L{coeff*1}
-
-    std::ostringstream oss;
-    if (coeff != 1.0) oss << coeff << "*";
-    oss << "s";
-    oss << "/(s^2 - " << omega * omega << ")";
-    return oss.str();
+RationalFunction transform_cosh(double omega, double coeff) {
+    return ct::transform_cosh(omega, coeff).to_runtime();
 }
 
 /**
  * @brief L{coeff * t * sinh(omega*t)} = coeff * 2*omega*s / (s^2 - omega^2)^2
  * @param omega The angular frequency.
  * @param coeff The coefficient.
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_t_sinh(double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return "0"; // t*sinh(0) = 0
-
-    std::ostringstream oss;
+RationalFunction transform_t_sinh(double omega, double coeff) {
     // L{t*sinh(wt)} = -d/ds(w/(s^2-w^2)) = - (0 - w*2s) / (s^2-w^2)^2 = 2ws / (s^2-w^2)^2
-    oss << coeff * 2.0 * omega << "*s";
-    oss << "/((s^2 - " << omega * omega << ")^2)";
-    return oss.str();
+    return ct::transform_t_sinh(omega, coeff).to_runtime();
 }
 
 /**
  * @brief L{coeff * t * cosh(omega*t)} = coeff * (s^2 + omega^2) / (s^2 - omega^2)^2
  * @param omega The angular frequency.
  * @param coeff The coefficient.
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_t_cosh(double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return Laplace::transform_t_pow_n(1, coeff); // t*cosh(0) = t
-
-    std::ostringstream oss;
+RationalFunction transform_t_cosh(double omega, double coeff) {
     // L{t*cosh(wt)} = -d/ds(s/(s^2-w^2)) = - (1*(s^2-w^2) - s*2s) / (s^2-w^2)^2
     // = - (s^2-w^2 - 2s^2) / (s^2-w^2)^2 = - (-w^2 - s^2) / (s^2-w^2)^2 = (s^2 + w^2) / (s^2-w^2)^2
-    if (coeff != 1.0) oss << coeff << "*";
-    oss << "(s^2 + " << omega * omega << ")";
-    oss << "/((s^2 - " << omega * omega << ")^2)";
-    return oss.str();
+    return ct::transform_t_cosh(omega, coeff).to_runtime();
 }
 
 /**
@@ -293,21 +176,10 @@ std::string transform_t_cosh(double omega, double coeff) {
  * @param a The constant in the exponent.
  * @param omega The angular frequency.
  * @param coeff The coefficient.
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_exp_sinh(double a, double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return "0"; // e^(at)*sinh(0) = 0
-
-    std::ostringstream oss;
-    oss << coeff * omega;
-    oss << "/((s";
-    if (a != 0.0) {
-        if (a > 0.0) oss << " - " << a;
-        else oss << " + " << -a;
-    }
-    oss << ")^2 - " << (omega * omega) << ")";
-    return oss.str();
+RationalFunction transform_exp_sinh(double a, double omega, double coeff) {
+    return ct::transform_exp_sinh(a, omega, coeff).to_runtime();
 }
 
 /**
@@ -315,99 +187,103 @@ std::string transform_exp_sinh(double a, double omega, double coeff) {
  * @param a The constant in the exponent.
  * @param omega The angular frequency.
  * @param coeff The coefficient.
- * @return String representation of the transform.
+ * @return The transform as a rational function of s.
  */
-std::string transform_exp_cosh(double a, double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return Laplace::transform_exp(a, coeff); // e^(at)*cosh(0) = e^(at)
-
-    std::ostringstream oss;
-    if (coeff != 1.0) {
-        oss << coeff << "*(s";
-        if (a > 0.0) oss << " - " << a;
-        else if (a < 0.0) oss << " + " << -a;
-        oss << ")";
-    } else {
-        oss << "(s";
-        if (a > 0.0) oss << " - " << a;
-        else if (a < 0.0) oss << " + " << -a;
-        oss << ")";
-    }
-    oss << "/((s";
-    if (a != 0.0) {
-        if (a > 0.0) oss << " - " << a;
-        else oss << " + " << -a;
-    }
-    oss << ")^2 - " << (omega * omega) << ")";
-    return oss.str();
+RationalFunction transform_exp_cosh(double a, double omega, double coeff) {
+    return ct::transform_exp_cosh(a, omega, coeff).to_runtime();
 }
 
 
-std::string transform_t_exp_sin(double a, double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return "0"; // t*e^(at)*sin(0) = 0
-
-    std::ostringstream oss;
-    oss << coeff * 2.0 * omega << "*(s";
-    if (a > 0.0) oss << " - " << a;
-    else if (a < 0.0) oss << " + " << -a;
-    oss << ")";
-    oss << "/(((s";
-    if (a > 0.0) oss << " - " << a;
-    else if (a < 0.0) oss << " + " << -a;
-    oss << ")^2 + " << (omega * omega) << ")^2)";
-    return oss.str();
+RationalFunction transform_t_exp_sin(double a, double omega, double coeff) {
+    return ct::transform_t_exp_sin(a, omega, coeff).to_runtime();
 }
 
-std::string transform_t_exp_cos(double a, double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return transform_t_exp(a, coeff); // t*e^(at)*cos(0) = t*e^(at)
-
-    std::ostringstream oss;
-    if (coeff != 1.0) oss << coeff << "*";
-    oss << "((s";
-    if (a > 0.0) oss << " - " << a;
-    else if (a < 0.0) oss << " + " << -a;
-    oss << ")^2 - " << (omega * omega) << ")";
-    oss << "/(((s";
-    if (a > 0.0) oss << " - " << a;
-    else if (a < 0.0) oss << " + " << -a;
-    oss << ")^2 + " << (omega * omega) << ")^2)";
-    return oss.str();
+RationalFunction transform_t_exp_cos(double a, double omega, double coeff) {
+    return ct::transform_t_exp_cos(a, omega, coeff).to_runtime();
 }
 
-std::string transform_t_exp_sinh(double a, double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return "0"; // t*e^(at)*sinh(0) = 0
-
-    std::ostringstream oss;
-    oss << coeff * 2.0 * omega << "*(s";
-    if (a > 0.0) oss << " - " << a;
-    else if (a < 0.0) oss << " + " << -a;
-    oss << ")";
-    oss << "/(((s";
-    if (a > 0.0) oss << " - " << a;
-    else if (a < 0.0) oss << " + " << -a;
-    oss << ")^2 - " << (omega * omega) << ")^2)";
-    return oss.str();
+RationalFunction transform_t_exp_sinh(double a, double omega, double coeff) {
+    return ct::transform_t_exp_sinh(a, omega, coeff).to_runtime();
+}
+
+
+RationalFunction transform_t_exp_cosh(double a, double omega, double coeff) {
+    return ct::transform_t_exp_cosh(a, omega, coeff).to_runtime();
 }
 
+namespace {
+
+// gain = coeff * Gamma(n + 1), moved into log_gain once the product would overflow.
+void set_gamma_gain(RationalFunction& f, double n, double coeff) {
+    f.gain = coeff * gamma_function(n + 1.0);
+    if (std::isfinite(f.gain)) return;
+    f.gain = coeff;
+    f.log_gain = log_gamma(n + 1.0);
+}
+
+} // namespace
+
+/**
+ * @brief L{coeff * t^n * e^(at) * osc(omega*t)} for any integer n >= 0, and for real
+ * n > -1 without an oscillation.
+ *
+ * With m = n + 1 and u = s - a (frequency shift), frequency differentiation gives
+ *   L{t^n e^(iwt)} = n! / (u - iw)^m = n! (u + iw)^m / (u^2 + w^2)^m,
+ * so sin and cos take the imaginary and real parts of (u + iw)^m over (u^2 + w^2)^m, and
+ * sinh and cosh the odd and even powers of w in (u + w)^m over (u^2 - w^2)^m. The
+ * numerator is sum_k C(m,k) u^k (iw)^(m-k), built by one recurrence on k. Without an
+ * oscillation the transform is Gamma(n+1) / u^(n+1) for real n as well.
+ * @param n The power of t.
+ * @param a The constant in the exponent (0 for no exponential).
+ * @param oscillation SIN, COS, SINH, COSH, or UNRECOGNIZED for t^n * e^(at) alone.
+ * @param omega The angular frequency.
+ * @param coeff The coefficient.
+ * @return The transform as a rational function of s.
+ */
+RationalFunction transform_t_n_exp_osc(double n, double a, FunctionType oscillation, double omega, double coeff) {
+    if (!(n > -1.0)) throw std::invalid_argument("n must be greater than -1 for L{t^n}.");
+    if (n > 1e9) throw std::invalid_argument("Power of t is too large.");
+    bool odd = oscillation == FunctionType::SIN || oscillation == FunctionType::SINH;
+    bool even = oscillation == FunctionType::COS || oscillation == FunctionType::COSH;
+    if (!odd && !even && oscillation != FunctionType::UNRECOGNIZED) {
+        throw std::invalid_argument("Oscillation must be sin, cos, sinh or cosh.");
+    }
+    if (coeff == 0.0 || (odd && omega == 0.0)) return {};
+    if (even && omega == 0.0) oscillation = FunctionType::UNRECOGNIZED; // cos(0) = cosh(0) = 1
+
+    RationalFunction f;
+    set_gamma_gain(f, n, coeff);
+    double whole = std::floor(n);
+    f.power = static_cast<int>(whole) + 1;
+    f.fractional_power = n - whole;
+    f.shift = a + 0.0;
+    if (oscillation == FunctionType::UNRECOGNIZED) {
+        f.numerator = {1.0};
+        f.denominator = {0.0, 1.0};
+        return f;
+    }
+    if (f.fractional_power != 0.0) {
+        throw std::invalid_argument("Non-integer powers of t are only supported alone or with exp(a*t).");
+    }
 
-std::string transform_t_exp_cosh(double a, double omega, double coeff) {
-    if (coeff == 0.0) return "0";
-    if (omega == 0.0) return transform_t_exp(a, coeff); // t*e^(at)*cosh(0) = t*e^(at)
-
-    std::ostringstream oss;
-    if (coeff != 1.0) oss << coeff << "*";
-    oss << "((s";
-    if (a > 0.0) oss << " - " << a;
-    else if (a < 0.0) oss << " + " << -a;
-    oss << ")^2 + " << (omega * omega) << ")";
-    oss << "/(((s";
-    if (a > 0.0) oss << " - " << a;
-    else if (a < 0.0) oss << " + " << -a;
-    oss << ")^2 - " << (omega * omega) << ")^2)";
-    return oss.str();
+    bool trig = oscillation == FunctionType::SIN || oscillation == FunctionType::COS;
+    int m = f.power;
+    f.denominator = {trig ? omega * omega : -omega * omega, 0.0, 1.0};
+    f.numerator.assign(static_cast<size_t>(m + 1), 0.0);
+
+    // term = C(m,k) w^(m-k), from k = m down; j = m - k is the power of w (or of iw)
+    double term = 1.0;
+    for (int k = m; k >= 0; --k) {
+        int j = m - k;
+        if ((j % 2 == 1) == odd) {
+            // i^j contributes (-1)^(j/2) to the real (j even) or imaginary (j odd) part
+            double sign = trig && (j / 2) % 2 == 1 ? -1.0 : 1.0;
+            f.numerator[static_cast<size_t>(k)] = sign * term;
+        }
+        if (k > 0) term *= omega * static_cast<double>(k) / static_cast<double>(j + 1);
+    }
+    if (odd) f.numerator.pop_back(); // The u^m coefficient has j = 0, never odd
+    return f;
 }
 
 } // namespace Laplace
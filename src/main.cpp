@@ -2,12 +2,13 @@
 #include <vector>
 #include <string>
 #include "../include/UI.h" 
+#include "../include/Plot.h"
 #include "Solve.cpp"
 
 
 int main() {
 
-    sf::RenderWindow window(sf::VideoMode(800, 600), "Laplace Calculator" );
+    sf::RenderWindow window(sf::VideoMode(1200, 600), "Laplace Calculator" );
     sf::Texture Mango ; 
 
     Mango.loadFromFile("../assets/pngtree-sweet-mango-fruit-png-png-image_11495826.png");
@@ -42,31 +43,66 @@ int main() {
     UI Ui ; 
     Ui.setup(labels , buttons , font , inputBox , inputText ) ;
 
+    // Bode and f(t) plots to the right of the calculator
+    PlotPanel plot(font, sf::FloatRect(800, 20, 380, 560));
+
+    // "=" hands the expression to a worker; its progress shows under the input box
+    AsyncSolver solver;
+    sf::Text statusText;
+    statusText.setFont(font);
+    statusText.setCharacterSize(18);
+    statusText.setFillColor(sf::Color(200, 200, 200));
+    statusText.setPosition(20, 76);
+
+    std::string status;
+
     while (window.isOpen()) {
         sf::Event event;
 
+        // With nothing to redraw, sleep until an event or the next cursor blink; while a
+        // worker is busy, wake at the frame rate to pick up its progress
+        bool waitedEvent = false;
+        if (!Ui.dirty.isSet()) {
+            sf::Time timeout = solver.busy() || plot.busy()
+                ? sf::milliseconds(16)
+                : sf::seconds(cursor.getBlinkRate()) - clock.getElapsedTime();
+            waitedEvent = waitEvent(window, event, timeout);
+        }
+
         if (clock.getElapsedTime().asSeconds() >= cursor.getBlinkRate()) {
             cursor.ReverseState();
             clock.restart();
+            Ui.dirty.mark();
         }
 
-        while (window.pollEvent(event)) {
+        while (waitedEvent || window.pollEvent(event)) {
+            waitedEvent = false;
+
             if (event.type == sf::Event::Closed)
                 window.close();
 
+            if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus)
+                Ui.dirty.mark();
+
+            if (plot.handleEvent(event)) {
+                Ui.dirty.mark(); // Zoomed or panned
+                continue;
+            }
+
             if (event.type == sf::Event::MouseButtonPressed) {
-                for (auto& button : buttons) {
-                    if (button.contains((sf::Vector2f)sf::Mouse::getPosition(window))) {
-                        button.press();
-                    }
+                int hit = Ui.batch.find((sf::Vector2f)sf::Mouse::getPosition(window));
+                if (hit != Laplace::HitGrid::npos) {
+                    buttons[hit].press();
                 }
             }
 
             if (event.type == sf::Event::MouseButtonReleased) {
-                for (auto& button : buttons) {
+                int hit = Ui.batch.find((sf::Vector2f)sf::Mouse::getPosition(window));
+                for (int i = 0; i < static_cast<int>(buttons.size()); ++i) {
+                    Button& button = buttons[i];
                     if (button.isPressed) {
                         button.release();
-                        if (button.contains((sf::Vector2f)sf::Mouse::getPosition(window))) {
+                        if (i == hit) {
                             std::wstring label = button.text.getString();
                             if (label == L"sin"|| label ==  L"cos" || label == L"sinh" || label == L"cosh" || label == L"^"  ) {
                                 inputStr += label + L"(" ;
@@ -90,14 +126,19 @@ int main() {
                                 }
                             }
                             else if (label == L"=") {
-                                Solve ComputeSoltion (inputStr) ;
+                                solver.submit(inputStr);
                             }
 
                             else if (label != L"del") {
                                 inputStr += label; 
                             }
 
+                            if (label != L"=") {
+                                solver.cancel(); // The input changed, so a running solve is stale
+                            }
+
                             inputText.setString(inputStr);
+                            Ui.dirty.mark();
                             
                         }
                     }
@@ -108,19 +149,46 @@ int main() {
 
         }
 
-        // Rendering
+        // Show the solve once the worker has it
+        if (std::optional<AsyncSolver::Result> solved = solver.poll()) {
+            if (solved->solved) {
+                inputStr = solved->display;
+                inputText.setString(inputStr);
+                cursor.setPosition(inputText.getPosition().x + inputText.getLocalBounds().width + 5 , inputText.getPosition().y + 4);
+            }
+            plot.setFunction(solved->terms, solved->transforms);
+            Ui.dirty.mark();
+        }
+        std::string newStatus = solver.busy()
+            ? "Solving... " + std::to_string(static_cast<int>(solver.progress() * 100)) + "%"
+            : "";
+        if (newStatus != status) {
+            status = newStatus;
+            statusText.setString(status);
+            Ui.dirty.mark();
+        }
+
+        if (plot.update())
+            Ui.dirty.mark();
+
+        if (!Ui.dirty.isSet())
+            continue;
+
+        // Rendering, only when something changed
         window.clear(sf::Color(50, 50, 50));
         window.draw(inputBox);
         window.draw(inputText );
-        for (auto& button : buttons)
-            button.draw(window);
+        window.draw(statusText);
+        Ui.batch.draw(window, buttons);
 
         if (cursor.IsShown()){
             window.draw(cursor);
         }
 
         window.draw(Mangosprite) ;
+        plot.draw(window);
         window.display();
+        Ui.dirty.clear();
     }
 
     return 0;
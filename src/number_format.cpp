@@ -0,0 +1,88 @@
+#include "../include/number_format.h"
+#include <algorithm>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <string>
+
+namespace Laplace {
+
+char* format_number(char* first, char* last, double value, const NumberFormat& format) {
+    std::to_chars_result result;
+    switch (format.style) {
+        case NumberStyle::General:
+            result = std::to_chars(first, last, value, std::chars_format::general, format.precision);
+            break;
+        case NumberStyle::Fixed:
+            result = std::to_chars(first, last, value, std::chars_format::fixed, format.precision);
+            break;
+        case NumberStyle::Scientific:
+            result = std::to_chars(first, last, value, std::chars_format::scientific, format.precision);
+            break;
+        default:
+            result = std::to_chars(first, last, value);
+            break;
+    }
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+void append_number(std::string& out, double value, const NumberFormat& format) {
+    char buffer[kNumberBufferSize];
+    if (char* end = format_number(buffer, buffer + sizeof buffer, value, format)) {
+        out.append(buffer, end);
+        return;
+    }
+
+    // Long Fixed text: 309 integer digits at most, plus sign, point and the decimals
+    size_t start = out.size();
+    out.resize(start + 312 + static_cast<size_t>(format.precision > 0 ? format.precision : 0));
+    char* end = format_number(&out[start], &out[0] + out.size(), value, format);
+    out.resize(end ? static_cast<size_t>(end - &out[0]) : start);
+}
+
+ScaledDecimal scaled_decimal(double value, double log_scale) {
+    if (value == 0.0) return {0.0, 0, 17};
+    double log_magnitude = std::log(std::fabs(value)) + log_scale;
+    double error = 2.0 * DBL_EPSILON * (std::fabs(log_magnitude) + 1.0);
+    int digits = std::clamp(static_cast<int>(-std::log10(error)), 1, 17);
+
+    double log10_magnitude = log_magnitude / std::log(10.0);
+    double exponent = std::floor(log10_magnitude);
+    double scale = std::pow(10.0, digits - 1);
+    double mantissa = std::round(std::pow(10.0, log10_magnitude - exponent) * scale) / scale;
+    if (mantissa >= 10.0) { // 9.9999... rounded up
+        mantissa /= 10.0;
+        exponent += 1.0;
+    }
+    return {std::copysign(mantissa, value), static_cast<long>(exponent), digits};
+}
+
+NumberFormat scaled_mantissa_format(const NumberFormat& format, int digits) {
+    NumberFormat mantissa_format = format;
+    switch (format.style) {
+        case NumberStyle::General:
+            mantissa_format.precision = std::min(format.precision, digits);
+            break;
+        case NumberStyle::Fixed:
+        case NumberStyle::Scientific: // Same digits, one exponent
+            mantissa_format.style = NumberStyle::Fixed;
+            mantissa_format.precision = std::min(format.precision, digits - 1);
+            break;
+        default:
+            break; // The rounded mantissa's shortest text has at most `digits` digits
+    }
+    return mantissa_format;
+}
+
+void append_scaled_number(std::string& out, double value, double log_scale, const NumberFormat& format) {
+    if (log_scale == 0.0) {
+        append_number(out, value, format);
+        return;
+    }
+    ScaledDecimal decimal = scaled_decimal(value, log_scale);
+    append_number(out, decimal.mantissa, scaled_mantissa_format(format, decimal.digits));
+    out += decimal.exponent < 0 ? "e-" : "e+";
+    out += std::to_string(std::labs(decimal.exponent));
+}
+
+} // namespace Laplace
@@ -0,0 +1,264 @@
+#include "../include/numerical_inverse.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "../include/frequency_response.h"
+#include "../include/inverse_laplace.h"
+#include "../include/number_format.h"
+#include "../include/parallel_chunks.h"
+
+namespace Laplace {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Points handed to each worker at a time; the per-point cost is a few hundred flops.
+const size_t kChunk = 4096;
+
+// Points written per invert() call in invert_grid.
+const size_t kGridBlock = 1 << 16;
+
+} // namespace
+
+TransformSampler make_sampler(const std::vector<RationalFunction>& terms) {
+    auto evaluator = std::make_shared<const FrequencyEvaluator>(terms);
+    return [evaluator](const std::complex<double>* s, std::complex<double>* out, size_t count) {
+        std::vector<double> s_re(count), s_im(count), out_re(count), out_im(count);
+        for (size_t i = 0; i < count; ++i) {
+            s_re[i] = s[i].real();
+            s_im[i] = s[i].imag();
+        }
+        evaluator->evaluate(s_re.data(), s_im.data(), count, out_re.data(), out_im.data());
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = {out_re[i], out_im[i]};
+        }
+    };
+}
+
+double convergence_abscissa(const std::vector<RationalFunction>& terms) {
+    double abscissa = -std::numeric_limits<double>::infinity();
+    for (const RationalFunction& term : terms) {
+        if (term.is_zero() || term.denominator.size() < 2) continue;
+        for (const Pole& pole : find_poles(term.denominator)) {
+            abscissa = std::max(abscissa, pole.location.real() + term.shift);
+        }
+    }
+    return abscissa;
+}
+
+NumericalInverter::NumericalInverter(TransformSampler transform, const InversionOptions& options)
+    : transform_(std::move(transform)), options_(options) {
+    if (!transform_) {
+        throw std::invalid_argument("Numerical inversion needs a transform to sample");
+    }
+    if (options_.nodes == 0) {
+        options_.nodes = options_.method == InversionMethod::Talbot ? 24 : 41;
+    }
+    if (options_.method == InversionMethod::DeHoog && options_.nodes % 2 == 0) {
+        ++options_.nodes; // de Hoog uses 2M + 1 terms
+    }
+    if (options_.nodes < 3) {
+        throw std::invalid_argument("Numerical inversion needs at least 3 nodes");
+    }
+    if (!(options_.tolerance > 0.0 && options_.tolerance < 1.0)) {
+        throw std::invalid_argument("de Hoog tolerance must lie in (0, 1)");
+    }
+    if (!std::isfinite(options_.abscissa)) {
+        options_.abscissa = 0.0; // No poles at all
+    }
+    if (options_.threads == 0) {
+        options_.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The Talbot contour has the same shape for every band, only its scale changes
+    if (options_.method == InversionMethod::Talbot) {
+        int m = options_.nodes;
+        cot_.assign(m, 0.0);
+        sigma_.assign(m, 0.0);
+        for (int k = 1; k < m; ++k) {
+            double theta = k * kPi / m;
+            cot_[k] = 1.0 / std::tan(theta);
+            sigma_[k] = theta + (theta * cot_[k] - 1.0) * cot_[k];
+        }
+    }
+}
+
+const NumericalInverter::Band& NumericalInverter::band(int octave) {
+    auto found = bands_.find(octave);
+    if (found != bands_.end()) return found->second;
+
+    Band band;
+    const int count = options_.nodes;
+    std::vector<std::complex<double>> values(count);
+
+    if (options_.method == InversionMethod::Talbot) {
+        // r = 2M / (5t) at the middle of the octave; the contour is shifted right of any
+        // pole with a positive real part and f picks up exp(shift * t) through the nodes.
+        double reference = std::ldexp(std::sqrt(2.0), octave);
+        double r = 2.0 * count / (5.0 * reference);
+        double shift = std::max(0.0, options_.abscissa);
+
+        band.nodes.resize(count);
+        band.nodes[0] = r + shift;
+        for (int k = 1; k < count; ++k) {
+            double theta = k * kPi / count;
+            band.nodes[k] = std::complex<double>(r * theta * cot_[k] + shift, r * theta);
+        }
+        transform_(band.nodes.data(), values.data(), count);
+
+        band.weights.resize(count);
+        band.weights[0] = 0.5 * r / count * values[0];
+        for (int k = 1; k < count; ++k) {
+            band.weights[k] = r / count * values[k] * std::complex<double>(1.0, sigma_[k]);
+        }
+    } else {
+        // Contour Re s = gamma, and a Fourier series with half period T = t_max, the top of
+        // the octave. The discretisation error is about exp(-2 (gamma - abscissa) T).
+        const int m = count / 2;
+        band.period = std::ldexp(1.0, octave + 1);
+        band.gamma = options_.abscissa - std::log(options_.tolerance) / (2.0 * band.period);
+
+        std::vector<std::complex<double>> s(count);
+        for (int k = 0; k < count; ++k) {
+            s[k] = std::complex<double>(band.gamma, k * kPi / band.period);
+        }
+        transform_(s.data(), values.data(), count);
+        values[0] *= 0.5;
+
+        // Quotient-difference algorithm, one column of the e and q tables at a time
+        std::vector<std::complex<double>> q(2 * m), e_prev(2 * m + 1, 0.0), e;
+        for (int i = 0; i < 2 * m; ++i) {
+            q[i] = values[i + 1] / values[i];
+        }
+        band.weights.assign(count, 0.0);
+        band.weights[0] = values[0];
+        for (int c = 1; c <= m; ++c) {
+            e.resize(2 * (m - c) + 1);
+            for (size_t i = 0; i < e.size(); ++i) {
+                e[i] = q[i + 1] - q[i] + e_prev[i + 1];
+            }
+            band.weights[2 * c - 1] = -q[0];
+            band.weights[2 * c] = -e[0];
+            if (c < m) {
+                q.resize(2 * (m - c));
+                for (size_t i = 0; i < q.size(); ++i) {
+                    q[i] = q[i + 1] * e[i + 1] / e[i];
+                }
+            }
+            e_prev.swap(e);
+        }
+    }
+
+    samples_taken_ += count;
+    return bands_.emplace(octave, std::move(band)).first->second;
+}
+
+double NumericalInverter::talbot(const Band& band, double t) const {
+    double sum = 0.0;
+    for (size_t k = 0; k < band.nodes.size(); ++k) {
+        sum += (band.weights[k] * std::exp(band.nodes[k] * t)).real();
+    }
+    return sum;
+}
+
+double NumericalInverter::de_hoog(const Band& band, double t) const {
+    // Continued fraction d_0 / (1 + d_1 z / (1 + d_2 z / ...)) in z = exp(i pi t / T) through
+    // its recurrence A_n = A_{n-1} + d_{n-1} z A_{n-2}, same for B.
+    const std::vector<std::complex<double>>& d = band.weights;
+    const size_t last = d.size() - 1; // 2M
+    std::complex<double> z = std::polar(1.0, kPi * t / band.period);
+
+    std::complex<double> a_prev = 0.0, a = d[0];
+    std::complex<double> b_prev = 1.0, b = 1.0;
+    for (size_t n = 2; n <= last; ++n) {
+        std::complex<double> dz = d[n - 1] * z;
+        std::complex<double> a_next = a + dz * a_prev;
+        std::complex<double> b_next = b + dz * b_prev;
+        a_prev = a;
+        a = a_next;
+        b_prev = b;
+        b = b_next;
+    }
+
+    // Remainder of the fraction estimated from its last two coefficients
+    std::complex<double> h = 0.5 * (1.0 + (d[last - 1] - d[last]) * z);
+    std::complex<double> remainder = -h * (1.0 - std::sqrt(1.0 + d[last] * z / (h * h)));
+    a += remainder * a_prev;
+    b += remainder * b_prev;
+
+    return std::exp(band.gamma * t) / band.period * (a / b).real();
+}
+
+void NumericalInverter::invert(const double* t, size_t count, double* f) {
+    // Serial pass: sample F for every octave the points fall in before the workers read bands_
+    int previous = std::numeric_limits<int>::min();
+    for (size_t i = 0; i < count; ++i) {
+        if (!(t[i] > 0.0) || !std::isfinite(t[i])) continue;
+        int octave = std::ilogb(t[i]);
+        if (octave != previous) {
+            band(octave);
+            previous = octave;
+        }
+    }
+
+    const bool talbot_method = options_.method == InversionMethod::Talbot;
+    parallel_chunks(count, options_.threads, kChunk, [&](size_t begin, size_t end) {
+        int octave = std::numeric_limits<int>::min();
+        const Band* current = nullptr;
+        for (size_t i = begin; i < end; ++i) {
+            if (!(t[i] > 0.0) || !std::isfinite(t[i])) {
+                f[i] = std::numeric_limits<double>::quiet_NaN();
+                continue;
+            }
+            int point_octave = std::ilogb(t[i]);
+            if (point_octave != octave) {
+                octave = point_octave;
+                current = &bands_.find(octave)->second;
+            }
+            f[i] = talbot_method ? talbot(*current, t[i]) : de_hoog(*current, t[i]);
+        }
+    });
+}
+
+bool invert_grid(NumericalInverter& inverter, double t_begin, double t_end, size_t count,
+                 bool logarithmic, std::ostream& out) {
+    if (logarithmic && !(t_begin > 0.0 && t_end > 0.0)) {
+        throw std::invalid_argument("A logarithmic time grid needs positive end points");
+    }
+
+    size_t block = std::min(count, kGridBlock);
+    std::vector<double> t(block), f(block);
+    std::string buffer;
+    char line[2 * kNumberBufferSize];
+    const NumberFormat format{NumberStyle::General, 15};
+
+    for (size_t first = 0; first < count; first += block) {
+        size_t n = std::min(block, count - first);
+        for (size_t j = 0; j < n; ++j) {
+            double x = count > 1 ? static_cast<double>(first + j) / static_cast<double>(count - 1) : 0.0;
+            t[j] = logarithmic ? t_begin * std::pow(t_end / t_begin, x) : t_begin + (t_end - t_begin) * x;
+        }
+        inverter.invert(t.data(), n, f.data());
+
+        buffer.clear();
+        for (size_t j = 0; j < n; ++j) {
+            // "%.15g %.15g\n" without printf's locale and format parsing
+            char* end = format_number(line, line + kNumberBufferSize, t[j], format);
+            *end++ = ' ';
+            end = format_number(end, line + sizeof line - 1, f[j], format);
+            *end++ = '\n';
+            buffer.append(line, end);
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!out) return false;
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace Laplace
@@ -0,0 +1,101 @@
+#include "../include/numerical_transform.h"
+#include "../include/parallel_chunks.h"
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace Laplace {
+
+namespace {
+
+// x = asinh(2/pi * log t) covers t from about 1e-30 to 1e30 over [-kRange, kRange].
+const double kRange = 4.5;
+const double kFirstStep = 0.5;
+const int kLevels = 8; // Final step 1/256, about 2300 nodes
+
+// exp(-kUnderflow) is below the smallest double, so those nodes contribute nothing.
+const double kUnderflow = 745.0;
+
+// Points of s handed to each worker at a time.
+const size_t kChunk = 16;
+
+} // namespace
+
+NumericalTransform::NumericalTransform(const TimeFunction& f, double tolerance) : tolerance_(tolerance) {
+    if (!(tolerance > 0.0 && tolerance < 1.0)) {
+        throw std::invalid_argument("Quadrature tolerance must lie in (0, 1)");
+    }
+
+    // Level 0 takes every multiple of the first step, later levels the odd multiples of
+    // their own step; within a level the nodes run in increasing t.
+    std::vector<double> x;
+    for (int level = 0; level < kLevels; ++level) {
+        double step = kFirstStep / (1 << level);
+        int stride = level == 0 ? 1 : 2;
+        int last = static_cast<int>(kRange / step);
+
+        x.clear();
+        for (int k = -last + (level == 0 ? 0 : (last % 2 == 0 ? 1 : 0)); k <= last; k += stride) {
+            x.push_back(k * step);
+        }
+
+        Level nodes;
+        nodes.t.resize(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            nodes.t[i] = std::exp(M_PI_2 * std::sinh(x[i]));
+        }
+        nodes.weighted.resize(x.size());
+        f.evaluate(nodes.t.data(), nodes.weighted.data(), x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            nodes.weighted[i] *= M_PI_2 * std::cosh(x[i]) * nodes.t[i]; // dt/dx
+        }
+        levels_.push_back(std::move(nodes));
+    }
+}
+
+TransformEstimate NumericalTransform::operator()(std::complex<double> s) const {
+    const double sigma = s.real();
+    const double omega = s.imag();
+
+    std::complex<double> estimate = 0.0;
+    double change = INFINITY;
+    for (int level = 0; level < kLevels; ++level) {
+        const Level& nodes = levels_[level];
+        std::complex<double> sum = 0.0;
+        for (size_t i = 0; i < nodes.t.size(); ++i) {
+            double t = nodes.t[i];
+            if (sigma * t > kUnderflow) break; // t only grows from here
+            double amplitude = nodes.weighted[i] * std::exp(-sigma * t); // Negative where f(t) is
+            if (amplitude == 0.0) continue; // Also keeps an overflowed f out of 0 * inf
+            sum += amplitude * std::complex<double>(std::cos(omega * t), -std::sin(omega * t));
+        }
+
+        double step = kFirstStep / (1 << level);
+        std::complex<double> refined = level == 0 ? step * sum : 0.5 * estimate + step * sum;
+        change = std::abs(refined - estimate);
+        estimate = refined;
+        if (level >= 2 && change <= tolerance_ * std::abs(estimate)) break;
+    }
+    return {estimate, change};
+}
+
+void NumericalTransform::evaluate(const std::vector<std::complex<double>>& s, std::vector<TransformEstimate>& out,
+                                  unsigned threads) const {
+    out.resize(s.size());
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    parallel_chunks(s.size(), threads, kChunk, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            out[i] = (*this)(s[i]);
+        }
+    });
+}
+
+size_t NumericalTransform::samples() const {
+    size_t count = 0;
+    for (const Level& level : levels_) {
+        count += level.t.size();
+    }
+    return count;
+}
+
+} // namespace Laplace
@@ -0,0 +1,540 @@
+#include "../include/output_writer.h"
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace Laplace {
+
+namespace {
+
+// Index of the only non-zero coefficient, or -1 if p has several (or none).
+int monomial_degree(const std::vector<double>& p) {
+    int degree = -1;
+    for (size_t k = 0; k < p.size(); ++k) {
+        if (p[k] == 0.0) continue;
+        if (degree != -1) return -1;
+        degree = static_cast<int>(k);
+    }
+    return degree;
+}
+
+// A finite number split at its exponent: "2.5e-07" is mantissa "2.5" and exponent -7.
+struct NumberParts {
+    std::string_view mantissa;
+    int exponent = 0;
+    bool scientific = false;
+};
+
+// value * e^log_scale, which need not fit a double, always comes out split.
+NumberParts split_number(char (&buffer)[kNumberBufferSize], double value, const NumberFormat& format,
+                         double log_scale = 0.0) {
+    NumberParts parts;
+    if (log_scale != 0.0) {
+        ScaledDecimal decimal = scaled_decimal(value, log_scale);
+        char* end = format_number(buffer, buffer + kNumberBufferSize, decimal.mantissa,
+                                  scaled_mantissa_format(format, decimal.digits));
+        parts.mantissa = std::string_view(buffer, static_cast<size_t>(end - buffer));
+        parts.exponent = static_cast<int>(decimal.exponent);
+        parts.scientific = true;
+        return parts;
+    }
+    char* end = format_number(buffer, buffer + kNumberBufferSize, value, format);
+    if (!end) end = format_number(buffer, buffer + kNumberBufferSize, value, NumberFormat()); // Long Fixed text
+    parts.mantissa = std::string_view(buffer, static_cast<size_t>(end - buffer));
+    size_t e = parts.mantissa.find('e');
+    if (e != std::string_view::npos) {
+        parts.exponent = std::atoi(buffer + e + 1);
+        parts.mantissa = parts.mantissa.substr(0, e);
+        parts.scientific = true;
+    }
+    return parts;
+}
+
+// --- plain ---
+
+class PlainWriter : public OutputWriter {
+public:
+    using OutputWriter::OutputWriter;
+
+    void transform(std::string& out, const std::vector<RationalFunction>& terms) const override {
+        append_sum(out, terms, numbers_);
+    }
+
+    void text(std::string& out, std::string_view text) const override {
+        out += text;
+    }
+
+    void error(std::string& out, std::string_view message) const override {
+        out += "error: ";
+        out += message;
+    }
+};
+
+// --- LaTeX and MathML ---
+
+// Both markups lay a transform out the way RationalFunction::to_string does (a monomial
+// numerator absorbs the gain, a repeated denominator keeps its factored power) but as a
+// fraction, so only the spelling of each piece differs between them.
+class MarkupWriter : public OutputWriter {
+public:
+    using OutputWriter::OutputWriter;
+
+    void transform(std::string& out, const std::vector<RationalFunction>& terms) const override {
+        begin_math(out);
+        if (terms.empty()) number(out, 0.0);
+        for (size_t i = 0; i < terms.size(); ++i) {
+            term(out, terms[i], i == 0);
+        }
+        end_math(out);
+    }
+
+protected:
+    virtual void begin_math(std::string& out) const = 0;
+    virtual void end_math(std::string& out) const = 0;
+    virtual void number(std::string& out, double magnitude, double log_scale = 0.0) const = 0; // magnitude * e^log_scale
+    virtual void variable(std::string& out, double shift) const = 0;       // s or (s - shift)
+    virtual void sign(std::string& out, bool minus, bool leading) const = 0; // Leading: "-" or nothing
+    virtual void times(std::string& out) const = 0;                         // Coefficient times factor
+    virtual void begin_group(std::string& out) const = 0;
+    virtual void end_group(std::string& out) const = 0;
+    virtual void begin_power(std::string& out) const = 0;
+    virtual void end_power(std::string& out, double exponent) const = 0;
+    virtual void begin_fraction(std::string& out) const = 0;
+    virtual void fraction_bar(std::string& out) const = 0;
+    virtual void end_fraction(std::string& out) const = 0;
+
+private:
+    void power_of_variable(std::string& out, double shift, int k) const {
+        if (k == 0) {
+            number(out, 1.0);
+            return;
+        }
+        if (k == 1) {
+            variable(out, shift);
+            return;
+        }
+        begin_power(out);
+        variable(out, shift);
+        end_power(out, k);
+    }
+
+    // |c| * e^log_scale * factor, leaving out a coefficient of 1
+    void scaled(std::string& out, double c, double log_scale, double shift, int k) const {
+        if (k == 0) {
+            number(out, c, log_scale);
+            return;
+        }
+        if (c != 1.0 || log_scale != 0.0) {
+            number(out, c, log_scale);
+            times(out);
+        }
+        power_of_variable(out, shift, k);
+    }
+
+    void polynomial(std::string& out, const std::vector<double>& p, double shift) const {
+        bool first = true;
+        for (size_t k = p.size(); k-- > 0;) {
+            if (p[k] == 0.0) continue;
+            sign(out, p[k] < 0.0, first);
+            first = false;
+            scaled(out, std::fabs(p[k]), 0.0, shift, static_cast<int>(k));
+        }
+        if (first) number(out, 0.0);
+    }
+
+    void term(std::string& out, const RationalFunction& f, bool first) const {
+        if (f.is_zero()) {
+            sign(out, false, first);
+            number(out, 0.0);
+            return;
+        }
+
+        int k = monomial_degree(f.numerator);
+        double leading = k >= 0 ? f.gain * f.numerator[static_cast<size_t>(k)] : f.gain;
+        sign(out, leading < 0.0, first);
+
+        begin_fraction(out);
+        if (k >= 0) {
+            scaled(out, std::fabs(leading), f.log_gain, f.shift, k);
+        } else if (std::fabs(leading) == 1.0 && f.log_gain == 0.0) {
+            polynomial(out, f.numerator, f.shift);
+        } else {
+            number(out, std::fabs(leading), f.log_gain);
+            times(out);
+            begin_group(out);
+            polynomial(out, f.numerator, f.shift);
+            end_group(out);
+        }
+
+        fraction_bar(out);
+        int d = monomial_degree(f.denominator);
+        if (d >= 0 && f.denominator[static_cast<size_t>(d)] == 1.0 && !f.is_rational()) {
+            begin_power(out);
+            variable(out, f.shift);
+            end_power(out, d * (f.power + f.fractional_power));
+        } else if (d >= 0 && f.denominator[static_cast<size_t>(d)] == 1.0) {
+            power_of_variable(out, f.shift, d * f.power);
+        } else if (f.power == 1 && f.is_rational()) {
+            polynomial(out, f.denominator, f.shift);
+        } else {
+            begin_power(out);
+            begin_group(out);
+            polynomial(out, f.denominator, f.shift);
+            end_group(out);
+            end_power(out, f.power + f.fractional_power);
+        }
+        end_fraction(out);
+    }
+};
+
+class LatexWriter : public MarkupWriter {
+public:
+    using MarkupWriter::MarkupWriter;
+
+    void text(std::string& out, std::string_view text) const override {
+        out += "\\text{";
+        escape(out, text);
+        out += "}";
+    }
+
+    void error(std::string& out, std::string_view message) const override {
+        out += "\\text{error: ";
+        escape(out, message);
+        out += "}";
+    }
+
+protected:
+    void begin_math(std::string&) const override {}
+    void end_math(std::string&) const override {}
+
+    void number(std::string& out, double magnitude, double log_scale = 0.0) const override {
+        if (std::isinf(magnitude)) {
+            out += "\\infty";
+            return;
+        }
+        if (std::isnan(magnitude)) {
+            out += "\\mathrm{NaN}";
+            return;
+        }
+        char buffer[kNumberBufferSize];
+        NumberParts parts = split_number(buffer, magnitude, numbers_, log_scale);
+        if (!parts.scientific) {
+            out += parts.mantissa;
+            return;
+        }
+        if (parts.mantissa != "1") {
+            out += parts.mantissa;
+            out += " \\times ";
+        }
+        out += "10^{";
+        out += std::to_string(parts.exponent);
+        out += "}";
+    }
+
+    void variable(std::string& out, double shift) const override {
+        if (shift == 0.0) {
+            out += "s";
+            return;
+        }
+        out += shift > 0.0 ? "\\left(s - " : "\\left(s + ";
+        number(out, std::fabs(shift));
+        out += "\\right)";
+    }
+
+    void sign(std::string& out, bool minus, bool leading) const override {
+        if (leading) {
+            if (minus) out += "-";
+        } else {
+            out += minus ? " - " : " + ";
+        }
+    }
+
+    void times(std::string& out) const override { out += " "; }
+    void begin_group(std::string& out) const override { out += "\\left("; }
+    void end_group(std::string& out) const override { out += "\\right)"; }
+    void begin_power(std::string&) const override {}
+
+    void end_power(std::string& out, double exponent) const override {
+        out += "^{";
+        append_number(out, exponent);
+        out += "}";
+    }
+
+    void begin_fraction(std::string& out) const override { out += "\\frac{"; }
+    void fraction_bar(std::string& out) const override { out += "}{"; }
+    void end_fraction(std::string& out) const override { out += "}"; }
+
+private:
+    static void escape(std::string& out, std::string_view text) {
+        for (char c : text) {
+            switch (c) {
+                case '\\': out += "\\textbackslash{}"; break;
+                case '~': out += "\\textasciitilde{}"; break;
+                case '^': out += "\\textasciicircum{}"; break;
+                case '{': case '}': case '$': case '&': case '#': case '_': case '%':
+                    out += '\\';
+                    out += c;
+                    break;
+                default: out += c; break;
+            }
+        }
+    }
+};
+
+class MathMLWriter : public MarkupWriter {
+public:
+    using MarkupWriter::MarkupWriter;
+
+    void text(std::string& out, std::string_view text) const override {
+        begin_math(out);
+        out += "<mtext>";
+        escape(out, text);
+        out += "</mtext>";
+        end_math(out);
+    }
+
+    void error(std::string& out, std::string_view message) const override {
+        begin_math(out);
+        out += "<merror><mtext>";
+        escape(out, message);
+        out += "</mtext></merror>";
+        end_math(out);
+    }
+
+protected:
+    void begin_math(std::string& out) const override {
+        out += "<math xmlns=\"http://www.w3.org/1998/Math/MathML\">";
+    }
+
+    void end_math(std::string& out) const override { out += "</math>"; }
+
+    void number(std::string& out, double magnitude, double log_scale = 0.0) const override {
+        if (std::isinf(magnitude)) {
+            out += "<mi>&#x221E;</mi>";
+            return;
+        }
+        if (std::isnan(magnitude)) {
+            out += "<mi>NaN</mi>";
+            return;
+        }
+        char buffer[kNumberBufferSize];
+        NumberParts parts = split_number(buffer, magnitude, numbers_, log_scale);
+        if (!parts.scientific) {
+            out += "<mn>";
+            out += parts.mantissa;
+            out += "</mn>";
+            return;
+        }
+        out += "<mrow>";
+        if (parts.mantissa != "1") {
+            out += "<mn>";
+            out += parts.mantissa;
+            out += "</mn><mo>&#x00D7;</mo>";
+        }
+        out += "<msup><mn>10</mn>";
+        if (parts.exponent < 0) out += "<mrow><mo>&#x2212;</mo>";
+        out += "<mn>";
+        out += std::to_string(std::abs(parts.exponent));
+        out += "</mn>";
+        if (parts.exponent < 0) out += "</mrow>";
+        out += "</msup></mrow>";
+    }
+
+    void variable(std::string& out, double shift) const override {
+        if (shift == 0.0) {
+            out += "<mi>s</mi>";
+            return;
+        }
+        out += "<mrow><mo>(</mo><mi>s</mi>";
+        out += shift > 0.0 ? "<mo>&#x2212;</mo>" : "<mo>+</mo>";
+        number(out, std::fabs(shift));
+        out += "<mo>)</mo></mrow>";
+    }
+
+    void sign(std::string& out, bool minus, bool leading) const override {
+        if (minus) {
+            out += "<mo>&#x2212;</mo>";
+        } else if (!leading) {
+            out += "<mo>+</mo>";
+        }
+    }
+
+    void times(std::string& out) const override { out += "<mo>&#x2062;</mo>"; } // Invisible times
+    void begin_group(std::string& out) const override { out += "<mrow><mo>(</mo>"; }
+    void end_group(std::string& out) const override { out += "<mo>)</mo></mrow>"; }
+    void begin_power(std::string& out) const override { out += "<msup><mrow>"; }
+
+    void end_power(std::string& out, double exponent) const override {
+        out += "</mrow><mn>";
+        append_number(out, exponent);
+        out += "</mn></msup>";
+    }
+
+    void begin_fraction(std::string& out) const override { out += "<mfrac><mrow>"; }
+    void fraction_bar(std::string& out) const override { out += "</mrow><mrow>"; }
+    void end_fraction(std::string& out) const override { out += "</mrow></mfrac>"; }
+
+private:
+    static void escape(std::string& out, std::string_view text) {
+        for (char c : text) {
+            switch (c) {
+                case '&': out += "&amp;"; break;
+                case '<': out += "&lt;"; break;
+                case '>': out += "&gt;"; break;
+                case '"': out += "&quot;"; break;
+                default: out += c; break;
+            }
+        }
+    }
+};
+
+// --- JSON ---
+
+class JsonWriter : public OutputWriter {
+public:
+    using OutputWriter::OutputWriter;
+
+    // The plain text plus every field of every term; coefficients are in u = s - shift,
+    // lowest power first, as in RationalFunction.
+    void transform(std::string& out, const std::vector<RationalFunction>& terms) const override {
+        out += "{\"transform\":\"";
+        size_t start = out.size();
+        append_sum(out, terms, numbers_);
+        escape_tail(out, start);
+        out += "\",\"terms\":[";
+        for (size_t i = 0; i < terms.size(); ++i) {
+            const RationalFunction& f = terms[i];
+            if (i > 0) out += ",";
+            out += "{\"gain\":";
+            number(out, f.gain);
+            out += ",\"numerator\":";
+            array(out, f.numerator);
+            out += ",\"denominator\":";
+            array(out, f.denominator);
+            out += ",\"power\":";
+            if (f.is_rational()) {
+                out += std::to_string(f.power);
+            } else {
+                number(out, f.power + f.fractional_power);
+            }
+            out += ",\"shift\":";
+            number(out, f.shift);
+            if (f.log_gain != 0.0) {
+                out += ",\"log_gain\":"; // gain * e^log_gain is the actual gain
+                number(out, f.log_gain);
+            }
+            out += "}";
+        }
+        out += "]}";
+    }
+
+    void text(std::string& out, std::string_view text) const override {
+        field(out, "result", text);
+    }
+
+    void error(std::string& out, std::string_view message) const override {
+        field(out, "error", message);
+    }
+
+private:
+    void number(std::string& out, double value) const {
+        if (std::isfinite(value)) {
+            append_number(out, value, numbers_);
+        } else {
+            out += "null"; // JSON has no inf or nan
+        }
+    }
+
+    void array(std::string& out, const std::vector<double>& values) const {
+        out += "[";
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) out += ",";
+            number(out, values[i]);
+        }
+        out += "]";
+    }
+
+    static void field(std::string& out, const char* name, std::string_view value) {
+        out += "{\"";
+        out += name;
+        out += "\":\"";
+        size_t start = out.size();
+        out += value;
+        escape_tail(out, start);
+        out += "\"}";
+    }
+
+    // Escapes out[start..] in place. Transforms never need it, so the scan is the common cost.
+    static void escape_tail(std::string& out, size_t start) {
+        size_t special = start;
+        while (special < out.size()) {
+            unsigned char c = static_cast<unsigned char>(out[special]);
+            if (c < 0x20 || c == '"' || c == '\\') break;
+            ++special;
+        }
+        if (special == out.size()) return;
+
+        std::string tail = out.substr(special);
+        out.resize(special);
+        for (char ch : tail) {
+            unsigned char c = static_cast<unsigned char>(ch);
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += ch;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else if (c == '\t') {
+                out += "\\t";
+            } else if (c < 0x20) {
+                static const char kHex[] = "0123456789abcdef";
+                out += "\\u00";
+                out += kHex[c >> 4];
+                out += kHex[c & 0xF];
+            } else {
+                out += ch;
+            }
+        }
+    }
+};
+
+} // namespace
+
+OutputFormat parse_output_format(std::string_view name) {
+    if (name == "plain") return OutputFormat::Plain;
+    if (name == "latex") return OutputFormat::Latex;
+    if (name == "mathml") return OutputFormat::MathML;
+    if (name == "json") return OutputFormat::Json;
+    throw std::invalid_argument("Unknown output format: " + std::string(name));
+}
+
+std::unique_ptr<OutputWriter> make_output_writer(OutputFormat format, const NumberFormat& numbers) {
+    switch (format) {
+        case OutputFormat::Latex: return std::make_unique<LatexWriter>(numbers);
+        case OutputFormat::MathML: return std::make_unique<MathMLWriter>(numbers);
+        case OutputFormat::Json: return std::make_unique<JsonWriter>(numbers);
+        default: return std::make_unique<PlainWriter>(numbers);
+    }
+}
+
+StreamOutput::StreamOutput(std::ostream& stream, size_t flush_at) : stream_(stream), flush_at_(flush_at) {
+    buffer_.reserve(flush_at_ + flush_at_ / 4);
+}
+
+StreamOutput::~StreamOutput() {
+    flush();
+}
+
+void StreamOutput::end_line() {
+    buffer_ += '\n';
+    if (buffer_.size() >= flush_at_) flush();
+}
+
+bool StreamOutput::flush() {
+    if (!buffer_.empty()) {
+        stream_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+    return static_cast<bool>(stream_);
+}
+
+} // namespace Laplace
@@ -1,8 +1,10 @@
 #include "../include/parser.h"
+#include "../include/transform_registry.h"
 #include <cctype>               // For isdigit ,   isalpha , isspace, isalnum
 #include <cmath>                
 #include <iostream>             
 #include <algorithm>            // For std::find_if
+#include <charconv>             // For std::from_chars
 
 
 // --- Token Constructors Definition ---
@@ -22,12 +24,31 @@ Token::Token(TokenType t, std::string txt) : type(t), text(std::move(txt)), valu
 // Constructor for tokens that are not numbers or have pre-defined text
 Token::Token(TokenType t, const char* txt_char) : type(t), text(txt_char), value(0.0) {}
 
-// --- Tokenizer Function Definition ---
+// --- Tokenizer Function Definitions ---
 std::vector<Token> tokenize(const std::string& input) {
+    std::vector<TokenView> views;
+    tokenize(input, views);
+
     std::vector<Token> tokens;
+    tokens.reserve(views.size());
+    for (const TokenView& view : views) {
+        tokens.emplace_back(view.type, std::string(view.text));
+    }
+    return tokens;
+}
+
+void tokenize(std::string_view input, std::vector<TokenView>& tokens, Laplace::Progress* progress) {
+    const size_t kReportBytes = 1 << 16;
+    tokens.clear();
     size_t pos = 0;
+    size_t reported = 0;
+    if (progress) progress->begin_stage(input.length());
 
     while (pos < input.length()) {
+        if (progress && pos - reported >= kReportBytes) {
+            progress->advance(pos - reported);
+            reported = pos;
+        }
         char current_char = input[pos];
 
         if (std::isspace(current_char)) {
@@ -37,65 +58,73 @@ std::vector<Token> tokenize(const std::string& input) {
 
         // Handle numbers: allows for leading '.', e.g., ".5"
         if (std::isdigit(current_char) || ( (current_char == '.'  )  && pos + 1 < input.length() && std::isdigit(input[pos+1]))) { // Check for leading digit or decimal point
-            std::string num_str;
+            size_t start = pos;
             bool decimal_found = false;
             while (pos < input.length() && (std::isdigit(input[pos]) || input[pos] == '.')) {
                 if (input[pos] == '.') {
                     if (decimal_found) {
                         // Allow only one decimal point
-                        throw std::runtime_error("Multiple decimal points in number: " + num_str + input[pos]);
+                        throw std::runtime_error("Multiple decimal points in number: " + std::string(input.substr(start, pos - start + 1)));
                     }
                     decimal_found = true;
                 }
-                num_str += input[pos];
                 pos++;
             }
-            tokens.emplace_back(TokenType::NUMBER, num_str);
+            std::string_view num_str = input.substr(start, pos - start);
+            double value = 0.0;
+            std::from_chars_result parsed = std::from_chars(num_str.data(), num_str.data() + num_str.size(), value);
+            if (parsed.ec == std::errc::result_out_of_range) {
+                throw std::runtime_error("Number out of range: " + std::string(num_str));
+            }
+            if (parsed.ec != std::errc() || parsed.ptr != num_str.data() + num_str.size()) {
+                throw std::runtime_error("Invalid number format: " + std::string(num_str));
+            }
+            tokens.push_back({TokenType::NUMBER, num_str, value});
             continue;
         }
 
         // Handle identifiers (function names, 't', 'PI', 'e', 'exp')
         if (std::isalpha(current_char)) {
-            std::string ident_str;
-            ident_str += current_char;
+            size_t start = pos;
             pos++;
             while (pos < input.length() && (std::isalnum(input[pos]))) { // allows letters and numbers
-                ident_str += input[pos];
                 pos++;
             }
             // All identifiers are parsed as IDENTIFIER type, their specific meaning (PI, sin, t)
             // will be interpreted by the parser based on their text.
-            tokens.emplace_back(TokenType::IDENTIFIER, ident_str);
+            tokens.push_back({TokenType::IDENTIFIER, input.substr(start, pos - start), 0.0});
             continue;
         }
 
         // Handle operators and parentheses
+        TokenType type;
         switch (current_char) {
-            case '+': tokens.emplace_back(TokenType::PLUS, "+"); pos++; break;
-            case '-': tokens.emplace_back(TokenType::MINUS, "-"); pos++; break;
-            case '*': tokens.emplace_back(TokenType::MULTIPLY, "*"); pos++; break;
-            case '/': tokens.emplace_back(TokenType::DIVIDE, "/"); pos++; break;
-            case '^': tokens.emplace_back(TokenType::POWER, "^"); pos++; break;
-            case '(': tokens.emplace_back(TokenType::LPAREN, "("); pos++; break;
-            case ')': tokens.emplace_back(TokenType::RPAREN, ")"); pos++; break;
+            case '+': type = TokenType::PLUS; break;
+            case '-': type = TokenType::MINUS; break;
+            case '*': type = TokenType::MULTIPLY; break;
+            case '/': type = TokenType::DIVIDE; break;
+            case '^': type = TokenType::POWER; break;
+            case '(': type = TokenType::LPAREN; break;
+            case ')': type = TokenType::RPAREN; break;
             default:
                 throw std::runtime_error("Unknown character in input: " + std::string(1, current_char));
         }
+        tokens.push_back({type, input.substr(pos, 1), 0.0});
+        pos++;
     }
-    tokens.emplace_back(TokenType::END_OF_INPUT, ""); // Mark the end of input
-    return tokens;
+    tokens.push_back({TokenType::END_OF_INPUT, std::string_view(), 0.0}); // Mark the end of input
 }
 
 // --- Parser Class Method Definitions ---
 
-Token& Parser::current_token() {
+const TokenView& Parser::current_token() {
     if (token_idx_ >= tokens_.size()) {
         throw std::runtime_error("Unexpected end of input.");
     }
     return tokens_[token_idx_];
 }
 
-Token& Parser::peek_token(size_t offset) {
+const TokenView& Parser::peek_token(size_t offset) {
     if (token_idx_ + offset >= tokens_.size()) {
         throw std::runtime_error("Unexpected end of input on peek.");
     }
@@ -108,368 +137,384 @@ void Parser::consume_token() {
     }
 }
 
+// Slice of the input from `begin` to the end of the last consumed token
+std::string_view Parser::source_since(const char* begin) const {
+    const TokenView& last = tokens_[token_idx_ - 1];
+    return std::string_view(begin, static_cast<size_t>(last.text.data() + last.text.size() - begin));
+}
 
-// Helper to parse arguments like "a*t", "omega*t", "a", "omega"
-// Returns the constant factor 'a' or 'omega'. Assumes 't' is the variable.
-double Parser::evaluate_simple_parameter_argument() {
-    double val = 1.0; // Default coefficient if only 't' is present, e.g., sin(t) -> omega=1
-    double sign = 1.0;
-    bool t_seen = false;
 
-    // Handle leading sign (e.g., exp(-3*t))
+// The whole input, a sum like parse_sum() whose operands are kept with their text as the
+// terms of the result. Most terms in practice are flat, "3*t*exp(-2*t)*sin(5*t)", and are
+// classified as they are read; the rest go into the DAG.
+void Parser::parse_terms() {
+    size_t reported = token_idx_; // Tokens counted toward progress
+    bool negative = false;
     if (current_token().type == TokenType::MINUS) {
-        sign = -1.0;
+        negative = true;
         consume_token();
     } else if (current_token().type == TokenType::PLUS) {
-        consume_token(); // consume optional '+'
-    }
-
-    // Parse the first component (number, PI, or t)
-    if (current_token().type == TokenType::NUMBER) {
-        val = current_token().value;
         consume_token();
-    } else if (current_token().text == "PI") {
-        val = M_PI;
-        consume_token();
-    } else if (current_token().text == "t") {
-        val = 1.0; // Implies 1*t
-        t_seen = true;
-        consume_token();
-    } else {
-        throw std::runtime_error("Invalid function argument. Expected number, PI, or 't', got: " + current_token().text);
     }
 
-    // Check for multiplication (e.g., 2*t, PI*t, t*2, t*PI)
-    if (current_token().type == TokenType::MULTIPLY) {
-        consume_token(); // Consume '*'
-        if (current_token().type == TokenType::NUMBER) {
-            if (t_seen) { // If 't*NUMBER', update coefficient
-                val *= current_token().value;
-            } else { // If 'NUMBER*NUMBER' or 'PI*NUMBER', update coefficient
-                val *= current_token().value;
-            }
-            consume_token();
-        } else if (current_token().text == "PI") {
-            if (t_seen) { // If 't*PI', update coefficient
-                val *= M_PI;
-            } else { // If 'NUMBER*PI' or 'PI*PI', update coefficient
-                val *= M_PI;
-            }
-            consume_token();
-        } else if (current_token().text == "t") {
-            if (t_seen) { // Already saw 't', like 't*t' (unsupported in arguments like sin(t*t))
-                throw std::runtime_error("Unexpected 't' in function argument (e.g., 't*t' is not supported).");
-            }
-            t_seen = true;
-            consume_token();
+    for (;;) {
+        const char* term_begin = current_token().text.data();
+        size_t term_start = token_idx_;
+        TopLevelTerm term;
+        term.flat = parse_flat_term(term.product);
+        if (term.flat) {
+            if (negative) term.product.coefficient *= -1.0;
         } else {
-            throw std::runtime_error("Expected number, PI, or 't' after '*' in argument, got: " + current_token().text);
+            token_idx_ = term_start; // Read it again, whole
+            term.node = parse_product();
+            if (negative) term.node = dag_.unary(Laplace::ExpressionKind::NEGATE, term.node);
         }
+        term.text = source_since(term_begin);
+        top_level_.push_back(term);
+        if (progress_) progress_->advance(token_idx_ - reported);
+        reported = token_idx_;
+
+        if (current_token().type != TokenType::PLUS && current_token().type != TokenType::MINUS) break;
+        negative = current_token().type == TokenType::MINUS;
+        consume_token(); // Consume '+' or '-'
     }
-    return val * sign;
 }
 
-
-
-// Parses the smallest unit: a number, a variable 't', a function call, or a parenthesized expression.
-ParsedTerm Parser::parse_factor() {
-    ParsedTerm term;
-    term.coefficient = 1.0; // Factors initially have coeff 1.0
-
-    // Handle numbers or constants like 'PI'
-    if (current_token().type == TokenType::NUMBER) {
-        term.type = FunctionType::CONSTANT;
-        term.coefficient *= current_token().value; // Apply explicit coefficient
-        term.original_term_str += current_token().text;
-        consume_token();
-        return term;
-    } else if (current_token().type == TokenType::IDENTIFIER && current_token().text == "PI") {
-        term.type = FunctionType::CONSTANT;
-        term.coefficient *= M_PI;
-        term.original_term_str += current_token().text;
-        consume_token();
-        return term;
-    } else if (current_token().type == TokenType::IDENTIFIER && current_token().text == "t") {
-        term.type = FunctionType::T_POW_N;
-        term.parameters.push_back(1.0); // Default to t^1
-        term.original_term_str += current_token().text;
-        consume_token();
-        if (current_token().type == TokenType::POWER) { // Handle t^n
-            term.original_term_str += current_token().text; // Add '^'
-            consume_token(); // Consume '^'
-            if (current_token().type != TokenType::NUMBER) {
-                throw std::runtime_error("Expected number for exponent after 't^', got: " + current_token().text);
-            }
-            term.parameters[0] = current_token().value; // Update power 'n'
-            term.original_term_str += current_token().text; // Add 'n'
-            consume_token();
+// flat_term := flat_factor {'*' flat_factor | flat_factor}, followed by '+', '-' or the end,
+// where a juxtaposed flat_factor is not a number.
+// Computes the product the way TermClassifier does for the same term, operation for
+// operation, so both give the same bits. Returns false with tokens consumed at anything
+// else, including the errors, which the DAG then reports.
+bool Parser::parse_flat_term(Laplace::FactorProduct& product) {
+    for (;;) {
+        Laplace::FactorProduct factor;
+        if (!parse_flat_factor(factor)) return false;
+        product.coefficient *= factor.coefficient;
+        product.t_power += factor.t_power;
+        if (factor.has_exp) {
+            product.a = product.has_exp ? product.a + factor.a : factor.a;
+            product.has_exp = true;
         }
-        return term;
-    } else if (current_token().type == TokenType::IDENTIFIER) {
-        // It's a function name: sin, cos, exp, sinh, cosh
-        std::string func_name = current_token().text;
-        term.original_term_str += current_token().text;
-        consume_token(); // Consume function name
-
-        if (func_name == "e") { // Special handling for 'e' followed by '^' for exp(at)
-            if (current_token().type == TokenType::POWER) {
-                term.original_term_str += current_token().text; // Add '^'
-                consume_token(); // Consume '^'
-            } else {
-                throw std::runtime_error("Identifier 'e' must be followed by '^' for exponentiation or '(' for exp() function: " + current_token().text);
-            }
+        if (factor.has_oscillation()) {
+            if (product.has_oscillation()) return false;
+            product.oscillation = factor.oscillation;
+            product.omega = factor.omega;
         }
 
-        if (current_token().type != TokenType::LPAREN) {
-            throw std::runtime_error("Expected '(' after function name " + func_name + ", got: " + current_token().text);
+        TokenType type = current_token().type;
+        if (type == TokenType::PLUS || type == TokenType::MINUS || type == TokenType::END_OF_INPUT) return true;
+        if (type == TokenType::MULTIPLY) {
+            consume_token();
+        } else if (type != TokenType::IDENTIFIER) {
+            return false; // '/', '^' and parentheses need the DAG, which also reports "2 3"
         }
-        term.original_term_str += current_token().text; // Add '('
-        consume_token(); // Consume '('
-
-        // Parse argument (e.g., 2*t, -3*t, t, PI*t)
-        double param_val = evaluate_simple_parameter_argument();
-        term.parameters.push_back(param_val);
-        // original_term_str for parameter part is built inside evaluate_simple_parameter_argument if needed
+    }
+}
 
-        if (current_token().type != TokenType::RPAREN) {
-            throw std::runtime_error("Expected ')' after function arguments, got: " + current_token().text);
-        }
-        term.original_term_str += current_token().text; // Add ')'
-        consume_token(); // Consume ')'
+// flat_factor := number | PI | t ['^' ['+' | '-'] (number | PI)] | e '^' flat_exponent
+//              | name '(' flat_argument ')'
+bool Parser::parse_flat_factor(Laplace::FactorProduct& factor) {
+    const TokenView& token = current_token();
+    if (token.type == TokenType::NUMBER || (token.type == TokenType::IDENTIFIER && token.text == "PI")) {
+        factor.coefficient = token.type == TokenType::NUMBER ? token.value : M_PI;
+        consume_token();
+        return current_token().type != TokenType::POWER; // Powers of constants need the DAG
+    }
+    if (token.type != TokenType::IDENTIFIER) return false;
+
+    std::string_view name = token.text;
+    consume_token();
+    if (name == "t") {
+        factor.t_power = 1.0;
+        if (current_token().type != TokenType::POWER) return true;
+        consume_token(); // Consume '^'
+        bool negative = current_token().type == TokenType::MINUS;
+        if (negative || current_token().type == TokenType::PLUS) consume_token();
+        const TokenView& exponent = current_token();
+        if (exponent.type != TokenType::NUMBER && !(exponent.type == TokenType::IDENTIFIER && exponent.text == "PI")) return false;
+        double p = exponent.type == TokenType::NUMBER ? exponent.value : M_PI;
+        consume_token();
+        if (negative) p *= -1.0;
+        factor.t_power = 1.0 * p + 0.0; // (t^1)^p, as classify_power() has it
+        return true;
+    }
 
-        if (func_name == "sin") {
-            term.type = FunctionType::SIN;
-        } else if (func_name == "cos") {
-            term.type = FunctionType::COS;
-        } else if (func_name == "exp" || func_name == "e") { // 'e' handled as exp
-            term.type = FunctionType::EXP;
-        } else if (func_name == "sinh") {
-            term.type = FunctionType::SINH;
-        } else if (func_name == "cosh") {
-            term.type = FunctionType::COSH;
-        } else {
-            throw std::runtime_error("Unrecognized function name: " + func_name);
-        }
-        return term;
-    } else if (current_token().type == TokenType::LPAREN) {
-        term.original_term_str += current_token().text; // Add '('
+    Laplace::ExpressionKind kind;
+    if (name == "sin") kind = Laplace::ExpressionKind::SIN;
+    else if (name == "cos") kind = Laplace::ExpressionKind::COS;
+    else if (name == "exp" || name == "e") kind = Laplace::ExpressionKind::EXP;
+    else if (name == "sinh") kind = Laplace::ExpressionKind::SINH;
+    else if (name == "cosh") kind = Laplace::ExpressionKind::COSH;
+    else return false;
+
+    double omega = 0.0;
+    if (name == "e") {
+        if (current_token().type != TokenType::POWER) return false;
+        consume_token(); // Consume '^'
+        if (!parse_flat_exponent(omega)) return false;
+    } else {
+        if (current_token().type != TokenType::LPAREN) return false;
         consume_token(); // Consume '('
-        
-        std::vector<ParsedTerm> sub_terms = parse_expression_in_parentheses_helper(); // Call helper for recursive parsing
-        if (sub_terms.size() != 1) {
-            throw std::runtime_error("Parenthesized expressions currently only support a single combined term for Laplace transform purposes.");
-        }
-        term = sub_terms[0]; // Take the result of the sub-expression as the factor
-
-        if (current_token().type != TokenType::RPAREN) {
-            throw std::runtime_error("Expected ')' after parenthesized expression, got: " + current_token().text);
-        }
-        term.original_term_str += current_token().text; // Add ')'
+        bool has_t = false;
+        if (!parse_flat_argument(omega, has_t)) return false;
         consume_token(); // Consume ')'
-        return term;
+    }
+    if (kind == Laplace::ExpressionKind::EXP) {
+        factor.has_exp = true;
+        factor.a = omega;
     } else {
-        throw std::runtime_error("Unexpected token while parsing factor: " + current_token().text);
+        factor.oscillation = kind;
+        factor.omega = omega;
     }
+    return true;
 }
 
+// flat_argument := ['+' | '-'] atom {'*' atom | (PI | t)} ')', atom := number | PI | t,
+// with t at most once. Leaves the ')' to the caller. Sets omega as classify_function() would.
+bool Parser::parse_flat_argument(double& omega, bool& has_t) {
+    bool negative = current_token().type == TokenType::MINUS;
+    if (negative || current_token().type == TokenType::PLUS) consume_token();
+    double coefficient = 1.0;
+    int t_count = 0;
+    for (;;) {
+        const TokenView& token = current_token();
+        if (token.type == TokenType::NUMBER) coefficient *= token.value;
+        else if (token.type == TokenType::IDENTIFIER && token.text == "PI") coefficient *= M_PI;
+        else if (token.type == TokenType::IDENTIFIER && token.text == "t") ++t_count;
+        else return false;
+        consume_token();
 
-// Parses terms with multiplication and division precedence
-ParsedTerm Parser::parse_multiplication() {
-    std::vector<ParsedTerm> factors;
-    factors.push_back(parse_factor()); // Get the first factor
+        TokenType type = current_token().type;
+        if (type == TokenType::RPAREN) break;
+        if (type == TokenType::MULTIPLY) {
+            consume_token();
+        } else if (type != TokenType::IDENTIFIER) {
+            return false; // Offsets, quotients and powers need the DAG
+        }
+    }
+    if (t_count > 1) return false;
+    if (negative) coefficient *= -1.0;
+    has_t = t_count == 1;
+    omega = 0.0 + coefficient; // Times t, or the sin(2) = sin(2*t) shorthand
+    return true;
+}
 
-    while (current_token().type == TokenType::MULTIPLY) {
-        consume_token(); // Consume '*'
-        factors.push_back(parse_factor()); // Get the next factor
+// flat_exponent := '(' flat_argument ')' | ['+' | '-'] t, the exponents of e^(-2*t) and
+// e^-t. Without parentheses a constant exponent is an error, which the DAG reports.
+bool Parser::parse_flat_exponent(double& a) {
+    if (current_token().type == TokenType::LPAREN) {
+        consume_token(); // Consume '('
+        bool has_t = false;
+        if (!parse_flat_argument(a, has_t)) return false;
+        consume_token(); // Consume ')'
+        return true;
     }
+    bool negative = current_token().type == TokenType::MINUS;
+    if (negative || current_token().type == TokenType::PLUS) consume_token();
+    if (!(current_token().type == TokenType::IDENTIFIER && current_token().text == "t")) return false;
+    consume_token();
+    a = negative ? 0.0 + -1.0 : 0.0 + 1.0;
+    return true;
+}
 
-    if (factors.empty()) {
-        throw std::runtime_error("No factors found in multiplication.");
+// sum := ['+' | '-'] product {('+' | '-') product}
+Laplace::NodeId Parser::parse_sum() {
+    size_t base = operand_stack_.size();
+    bool negative = false;
+    if (current_token().type == TokenType::MINUS) {
+        negative = true;
+        consume_token();
+    } else if (current_token().type == TokenType::PLUS) {
+        consume_token();
     }
 
-    ParsedTerm combined_term;
-    combined_term.coefficient = 1.0;
-    std::string original_str_parts;
+    for (;;) {
+        Laplace::NodeId term = parse_product();
+        if (negative) term = dag_.unary(Laplace::ExpressionKind::NEGATE, term);
+        operand_stack_.push_back(term);
 
-    // Accumulate overall coefficient and build original string representation
-    for (const auto& factor : factors) {
-        combined_term.coefficient *= factor.coefficient;
-        if (!original_str_parts.empty()) {
-            original_str_parts += "*";
-        }
-        original_str_parts += factor.original_term_str;
-    }
-    combined_term.original_term_str = original_str_parts;
-
-    // If only one factor, return it directly (after applying its coefficient)
-    if (factors.size() == 1) {
-        combined_term.type = factors[0].type;
-        combined_term.parameters = factors[0].parameters;
-        return combined_term;
-    }
-
-    // New logic for combining multiple factors
-    double t_exponent = 0.0;
-    bool has_t_term = false;
-    double exp_a = 0.0;
-    bool has_exp_term = false;
-    double trig_omega = 0.0;
-    FunctionType trig_hyper_type = FunctionType::UNRECOGNIZED;
-
-    for (const auto& factor : factors) {
-        if (factor.type == FunctionType::CONSTANT) {
-            // Coefficient already handled
-        } else if (factor.type == FunctionType::T_POW_N) {
-            has_t_term = true;
-            t_exponent += factor.parameters[0]; // Sum exponents for t
-        } else if (factor.type == FunctionType::EXP) {
-            if (has_exp_term) {
-                throw std::runtime_error("Multiple exponential functions in multiplication are not supported.");
-            }
-            has_exp_term = true;
-            exp_a = factor.parameters[0];
-        } else if (factor.type == FunctionType::SIN || factor.type == FunctionType::COS ||
-                   factor.type == FunctionType::SINH || factor.type == FunctionType::COSH) {
-            if (trig_hyper_type != FunctionType::UNRECOGNIZED) {
-                throw std::runtime_error("Multiple trigonometric/hyperbolic functions in multiplication are not supported.");
-            }
-            trig_hyper_type = factor.type;
-            trig_omega = factor.parameters[0];
-        } else {
-            throw std::runtime_error("Unsupported function type in multiplication: " + factor.text_representation());
-        }
+        if (current_token().type != TokenType::PLUS && current_token().type != TokenType::MINUS) break;
+        negative = current_token().type == TokenType::MINUS;
+        consume_token(); // Consume '+' or '-'
     }
 
-    // Determine the final combined type
-    if (has_t_term && t_exponent > 1.0) {
-        // If t has a power greater than 1, and there are other functional terms (exp, trig/hyper),
-        // it's an unsupported combination for now.
-        if (has_exp_term || trig_hyper_type != FunctionType::UNRECOGNIZED) {
-            throw std::runtime_error("Unsupported complex multiplication: t^n (n>1) with other functions.");
-        }
-        // If only t^n (n>1) and constants, it's just T_POW_N
-        combined_term.type = FunctionType::T_POW_N;
-        combined_term.parameters.push_back(t_exponent);
-    } else if (has_t_term && t_exponent == 1.0) { // t^1
-        if (has_exp_term && trig_hyper_type != FunctionType::UNRECOGNIZED) {
-            // t * exp(at) * trig(omega*t)
-            if (trig_hyper_type == FunctionType::SIN) combined_term.type = FunctionType::T_EXP_SIN;
-            else if (trig_hyper_type == FunctionType::COS) combined_term.type = FunctionType::T_EXP_COS;
-            else if (trig_hyper_type == FunctionType::SINH) combined_term.type = FunctionType::T_EXP_SINH;
-            else if (trig_hyper_type == FunctionType::COSH) combined_term.type = FunctionType::T_EXP_COSH;
-            combined_term.parameters.push_back(exp_a);
-            combined_term.parameters.push_back(trig_omega);
-        } else if (has_exp_term) {
-            // t * exp(at)
-            combined_term.type = FunctionType::T_EXP;
-            combined_term.parameters.push_back(exp_a);
-        } else if (trig_hyper_type != FunctionType::UNRECOGNIZED) {
-            // t * trig(omega*t)
-            if (trig_hyper_type == FunctionType::SIN) combined_term.type = FunctionType::T_SIN;
-            else if (trig_hyper_type == FunctionType::COS) combined_term.type = FunctionType::T_COS;
-            else if (trig_hyper_type == FunctionType::SINH) combined_term.type = FunctionType::T_SINH;
-            else if (trig_hyper_type == FunctionType::COSH) combined_term.type = FunctionType::T_COSH;
-            combined_term.parameters.push_back(trig_omega);
-        } else {
-            // Just t^1 and constants
-            combined_term.type = FunctionType::T_POW_N;
-            combined_term.parameters.push_back(1.0);
+    Laplace::NodeId sum = dag_.combine(Laplace::ExpressionKind::SUM, operand_stack_.data() + base, operand_stack_.size() - base);
+    operand_stack_.resize(base);
+    return sum;
+}
+
+// product := power {('*' | '/') power | power}
+// Juxtaposition multiplies, as in the parsers for s and for f(t): "2t", "3(t + 1)", "t sin(t)".
+// The juxtaposed factor must not start with a number, so a typo like "2 3" is an error, not 6.
+Laplace::NodeId Parser::parse_product() {
+    size_t base = operand_stack_.size();
+    operand_stack_.push_back(parse_power());
+    for (;;) {
+        TokenType type = current_token().type;
+        bool divide = type == TokenType::DIVIDE;
+        if (type == TokenType::MULTIPLY || divide) {
+            consume_token(); // Consume '*' or '/'
+        } else if (type != TokenType::IDENTIFIER && type != TokenType::LPAREN) {
+            break;
         }
-    } else if (has_exp_term && trig_hyper_type != FunctionType::UNRECOGNIZED) {
-        // exp(at) * trig(omega*t)
-        if (trig_hyper_type == FunctionType::SIN) combined_term.type = FunctionType::EXP_SIN;
-        else if (trig_hyper_type == FunctionType::COS) combined_term.type = FunctionType::EXP_COS;
-        else if (trig_hyper_type == FunctionType::SINH) combined_term.type = FunctionType::EXP_SINH;
-        else if (trig_hyper_type == FunctionType::COSH) combined_term.type = FunctionType::EXP_COSH;
-        combined_term.parameters.push_back(exp_a);
-        combined_term.parameters.push_back(trig_omega);
-    } else if (has_exp_term) {
-        // Just exp(at) and constants
-        combined_term.type = FunctionType::EXP;
-        combined_term.parameters.push_back(exp_a);
-    } else if (trig_hyper_type != FunctionType::UNRECOGNIZED) {
-        // Just trig/hyperbolic and constants
-        combined_term.type = trig_hyper_type;
-        combined_term.parameters.push_back(trig_omega);
-    } else {
-        // Only constants were multiplied
-        combined_term.type = FunctionType::CONSTANT;
+        Laplace::NodeId factor = parse_power();
+        operand_stack_.push_back(divide ? dag_.unary(Laplace::ExpressionKind::RECIPROCAL, factor) : factor);
     }
 
-    return combined_term;
+    Laplace::NodeId product = dag_.combine(Laplace::ExpressionKind::PRODUCT, operand_stack_.data() + base, operand_stack_.size() - base);
+    operand_stack_.resize(base);
+    return product;
 }
 
+// power := primary ['^' exponent]
+Laplace::NodeId Parser::parse_power() {
+    Laplace::NodeId base = parse_primary();
+    if (current_token().type != TokenType::POWER) return base;
+    consume_token(); // Consume '^'
+    return dag_.power(base, parse_exponent());
+}
 
-// Helper function to parse an expression that is expected to be within parentheses.
-// It's like a mini-parse_expression, but it expects to find ')' at the end.
-std::vector<ParsedTerm> Parser::parse_expression_in_parentheses_helper() {
-    std::vector<ParsedTerm> terms_in_paren;
-    double overall_sign_for_term = 1.0;
+// exponent := ['+' | '-'] primary ['^' exponent], so t^-1 and e^-t need no parentheses and
+// powers group to the right: e^t^2 is e^(t^2), as in the parser for f(t).
+// e^e^...^t nests through here, so an exponent counts toward kMaxDepth like a parenthesis.
+Laplace::NodeId Parser::parse_exponent() {
+    bool negative = current_token().type == TokenType::MINUS;
+    if (negative || current_token().type == TokenType::PLUS) consume_token();
+    if (++depth_ > kMaxDepth) throw std::runtime_error("Expression is nested too deeply.");
+    Laplace::NodeId exponent = parse_power();
+    --depth_;
+    return negative ? dag_.unary(Laplace::ExpressionKind::NEGATE, exponent) : exponent;
+}
 
-    // Handle initial sign inside parentheses, e.g. (-sin(t))
-    if (current_token().type == TokenType::MINUS) {
-        overall_sign_for_term = -1.0;
+// primary := number | PI | t | 'e' | name '(' sum ')' | 'e' '^' '(' sum ')' | '(' sum ')'
+// e^(x) is exp(x), so e^(2) is exp(2*t) like sin(2) is sin(2*t). Without parentheses e is
+// the number, which must be raised to a power with t in it: e^-t and e^(t)^2 are exp(-t)
+// and exp(2*t), while e^2*t and e^t^2 = e^(t^2) are rejected rather than guessed at.
+Laplace::NodeId Parser::parse_primary() {
+    const TokenView& token = current_token();
+    if (token.type == TokenType::NUMBER) {
         consume_token();
-    } else if (current_token().type == TokenType::PLUS) {
+        return dag_.number(token.value);
+    }
+    if (token.type == TokenType::IDENTIFIER && token.text == "PI") {
         consume_token();
+        return dag_.number(M_PI);
+    }
+    if (token.type == TokenType::IDENTIFIER && token.text == "t") {
+        consume_token();
+        return dag_.variable();
     }
 
-    // Parse the first term within parentheses
-    ParsedTerm current_parsed_term = parse_multiplication();
-    current_parsed_term.coefficient *= overall_sign_for_term;
-    terms_in_paren.push_back(current_parsed_term);
-
-    // Continue parsing subsequent terms connected by + or - until RPAREN or END_OF_INPUT
-    while (current_token().type == TokenType::PLUS || current_token().type == TokenType::MINUS) {
-        overall_sign_for_term = (current_token().type == TokenType::PLUS) ? 1.0 : -1.0;
-        consume_token(); // Consume '+' or '-'
+    bool function = token.type == TokenType::IDENTIFIER;
+    std::string_view func_name = token.text;
+    if (!function && token.type != TokenType::LPAREN) {
+        throw std::runtime_error("Unexpected token while parsing factor: " + std::string(token.text));
+    }
+    if (function) {
+        consume_token(); // Consume function name
+        if (func_name == "e") {
+            if (current_token().type != TokenType::POWER) {
+                throw std::runtime_error("Identifier 'e' must be followed by '^' for exponentiation or '(' for exp() function: " + std::string(current_token().text));
+            }
+            if (peek_token(1).type != TokenType::LPAREN) return dag_.number(M_E); // parse_power() takes the '^'
+            consume_token(); // Consume '^'
+        }
+        if (current_token().type != TokenType::LPAREN) {
+            throw std::runtime_error("Expected '(' after function name " + std::string(func_name) + ", got: " + std::string(current_token().text));
+        }
+    }
+    Laplace::ExpressionKind kind = Laplace::ExpressionKind::NUMBER;
+    if (function) {
+        if (func_name == "sin") kind = Laplace::ExpressionKind::SIN;
+        else if (func_name == "cos") kind = Laplace::ExpressionKind::COS;
+        else if (func_name == "exp" || func_name == "e") kind = Laplace::ExpressionKind::EXP;
+        else if (func_name == "sinh") kind = Laplace::ExpressionKind::SINH;
+        else if (func_name == "cosh") kind = Laplace::ExpressionKind::COSH;
+        else throw std::runtime_error("Unrecognized function name: " + std::string(func_name));
+    }
 
-        // Parse the next additive term
-        current_parsed_term = parse_multiplication();
-        current_parsed_term.coefficient *= overall_sign_for_term;
-        terms_in_paren.push_back(current_parsed_term);
+    consume_token(); // Consume '('
+    if (++depth_ > kMaxDepth) throw std::runtime_error("Expression is nested too deeply.");
+    Laplace::NodeId inner = parse_sum();
+    --depth_;
+    if (current_token().type != TokenType::RPAREN) {
+        throw std::runtime_error(std::string(function ? "Expected ')' after function arguments, got: "
+                                                      : "Expected ')' after parenthesized expression, got: ") +
+                                 std::string(current_token().text));
     }
-    // The calling `parse_factor` will consume the RPAREN.
-    return terms_in_paren;
+    consume_token(); // Consume ')'
+    return function ? dag_.unary(kind, inner) : inner;
 }
 
-std::vector<ParsedTerm> Parser::parse_expression(const std::string& input) {
-    tokens_ = tokenize(input); // Call the external tokenize function
-    token_idx_ = 0; // Reset token index
-
-    std::vector<ParsedTerm> result_terms; // Local vector to hold results
-
-    if (tokens_.empty() || current_token().type == TokenType::END_OF_INPUT) {
-        return result_terms; // Empty input, return empty list
+// Names the family of each product a top-level term expands to, from the transform registry.
+void Parser::add_terms(const TopLevelTerm& term) {
+    if (term.flat) {
+        add_term(term.product, term.text);
+        return;
+    }
+    Laplace::TermClassifier::Range range = classifier_.classify(term.node);
+    for (size_t k = 0; k < range.count; ++k) {
+        add_term(classifier_.product(range.first + k), term.text);
     }
+}
 
-    // Handle leading sign for the first term
-    double overall_sign_for_term = 1.0;
-    if (current_token().type == TokenType::MINUS) {
-        overall_sign_for_term = -1.0;
-        consume_token();
-    } else if (current_token().type == TokenType::PLUS) {
-        consume_token();
+// One product as a ParsedTerm, with the text of the term it came from.
+void Parser::add_term(const Laplace::FactorProduct& product, std::string_view text) {
+    FunctionType oscillation = FunctionType::UNRECOGNIZED;
+    switch (product.oscillation) {
+        case Laplace::ExpressionKind::SIN: oscillation = FunctionType::SIN; break;
+        case Laplace::ExpressionKind::COS: oscillation = FunctionType::COS; break;
+        case Laplace::ExpressionKind::SINH: oscillation = FunctionType::SINH; break;
+        case Laplace::ExpressionKind::COSH: oscillation = FunctionType::COSH; break;
+        default: break;
     }
 
-    // Parse the first additive term (which can contain multiplications)
-    ParsedTerm current_parsed_term = parse_multiplication(); // Use the new function
-    current_parsed_term.coefficient *= overall_sign_for_term;
-    result_terms.push_back(current_parsed_term);
+    const Laplace::TransformEntry* family = Laplace::find_product_family(product.t_power, product.has_exp, oscillation);
+    if (!family) {
+        throw std::runtime_error("Unsupported combination of factors in multiplication: " + std::string(text));
+    }
+    ParsedTerm parsed;
+    parsed.coefficient = product.coefficient;
+    parsed.type = family->type;
+    if (family->signature.t_power == Laplace::kAnyPower) parsed.parameters.push_back(product.t_power);
+    if (product.has_exp) parsed.parameters.push_back(product.a);
+    if (product.has_oscillation()) parsed.parameters.push_back(product.omega);
+    parsed.original_term_str = text;
+    terms_.push_back(parsed);
+}
 
-    // Continue parsing subsequent additive terms connected by + or -
-    while (current_token().type == TokenType::PLUS || current_token().type == TokenType::MINUS) {
-        overall_sign_for_term = (current_token().type == TokenType::PLUS) ? 1.0 : -1.0;
-        consume_token(); // Consume '+' or '-'
+const std::vector<ParsedTerm>& Parser::parse(std::string_view input, Laplace::Progress* progress) {
+    terms_.clear();
+    top_level_.clear();
+    operand_stack_.clear();
+    tokenize(input, tokens_, progress); // Views into `input`; reuses the token buffer from the last call
+    token_idx_ = 0; // Reset token index
+    depth_ = 0;
+    progress_ = progress;
+    if (progress_) progress_->begin_stage(tokens_.size());
 
-        // Parse the next additive term
-        current_parsed_term = parse_multiplication(); // Use the new function
-        current_parsed_term.coefficient *= overall_sign_for_term;
-        result_terms.push_back(current_parsed_term);
+    if (tokens_.empty() || current_token().type == TokenType::END_OF_INPUT) {
+        if (progress_) progress_->begin_stage(0); // Nothing to classify either
+        return terms_; // Empty input, return empty list
     }
 
+    // First pass: flat terms classified, the others into the DAG, which has at most one node per token
+    dag_.reset(tokens_.size());
+    parse_terms();
     if (current_token().type != TokenType::END_OF_INPUT) {
-        throw std::runtime_error("Unexpected token at end of expression: " + current_token().text);
+        throw std::runtime_error("Unexpected token at end of expression: " + std::string(current_token().text));
+    }
+
+    // Second pass: classification, one top-level term at a time so each keeps its text
+    if (progress_) progress_->begin_stage(top_level_.size());
+    classifier_.reset(dag_, progress_);
+    for (const TopLevelTerm& term : top_level_) {
+        add_terms(term);
+        if (progress_) progress_->advance();
     }
-    return result_terms;
+    return terms_;
+}
+
+std::vector<ParsedTerm> Parser::parse_expression(const std::string& input) {
+    return parse(input);
 }
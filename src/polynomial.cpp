@@ -0,0 +1,243 @@
+#include "../include/polynomial.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+
+namespace Laplace {
+
+namespace {
+
+using Complex = std::complex<double>;
+
+double max_magnitude(const Polynomial& p) {
+    double largest = 0.0;
+    for (double c : p) largest = std::max(largest, std::fabs(c));
+    return largest;
+}
+
+// In-place iterative radix-2 FFT; data.size() is a power of two. The inverse is unscaled.
+void fft(std::vector<Complex>& data, bool inverse) {
+    const size_t n = data.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+    }
+
+    // Twiddles straight from cos/sin rather than by repeated multiplication, which would
+    // let rounding grow with the transform length.
+    std::vector<Complex> roots(n / 2);
+    for (size_t k = 0; k < n / 2; ++k) {
+        double angle = (inverse ? 2.0 : -2.0) * M_PI * static_cast<double>(k) / static_cast<double>(n);
+        roots[k] = Complex(std::cos(angle), std::sin(angle));
+    }
+
+    for (size_t length = 2; length <= n; length <<= 1) {
+        size_t stride = n / length;
+        for (size_t start = 0; start < n; start += length) {
+            for (size_t k = 0; k < length / 2; ++k) {
+                Complex even = data[start + k];
+                Complex odd = data[start + k + length / 2] * roots[k * stride];
+                data[start + k] = even + odd;
+                data[start + k + length / 2] = even - odd;
+            }
+        }
+    }
+}
+
+} // namespace
+
+void trim(Polynomial& p) {
+    while (p.size() > 1 && p.back() == 0.0) p.pop_back();
+    if (p.empty()) p.push_back(0.0);
+}
+
+bool is_zero(const Polynomial& p) {
+    return std::all_of(p.begin(), p.end(), [](double c) { return c == 0.0; });
+}
+
+int degree(const Polynomial& p) {
+    for (size_t k = p.size(); k-- > 0;) {
+        if (p[k] != 0.0) return static_cast<int>(k);
+    }
+    return -1;
+}
+
+Polynomial add(const Polynomial& a, const Polynomial& b, double sign) {
+    Polynomial sum(std::max(a.size(), b.size()), 0.0);
+    for (size_t k = 0; k < a.size(); ++k) sum[k] += a[k];
+    for (size_t k = 0; k < b.size(); ++k) sum[k] += sign * b[k];
+    trim(sum);
+    return sum;
+}
+
+Polynomial multiply(const Polynomial& a, const Polynomial& b) {
+    if (std::min(a.size(), b.size()) < kFftThreshold) return multiply_schoolbook(a, b);
+    return multiply_fft(a, b);
+}
+
+Polynomial multiply_schoolbook(const Polynomial& a, const Polynomial& b) {
+    if (a.empty() || b.empty()) return {0.0};
+    Polynomial product(a.size() + b.size() - 1, 0.0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == 0.0) continue;
+        for (size_t j = 0; j < b.size(); ++j) {
+            product[i + j] += a[i] * b[j];
+        }
+    }
+    trim(product);
+    return product;
+}
+
+// With z = a + i b, z^2 = a^2 - b^2 + 2i ab, so one forward and one inverse transform give
+// the product as half the imaginary part. a and b are scaled to unit size first so neither
+// swamps the other in z, and s is replaced by beta s, which evens out coefficients that
+// grow or shrink geometrically (the powers of the root in (s + 1000)^n).
+Polynomial multiply_fft(const Polynomial& a, const Polynomial& b) {
+    int da = degree(a), db = degree(b);
+    if (da < 0 || db < 0) return {0.0};
+
+    // beta^(da + db) = |a_0 b_0| / |a_da b_db| when both ends are non-zero
+    double log_beta = 0.0;
+    if (a[0] != 0.0 && b[0] != 0.0 && da + db > 0) {
+        double ends = std::fabs(a[0] * b[0]);
+        double leads = std::fabs(a[static_cast<size_t>(da)] * b[static_cast<size_t>(db)]);
+        log_beta = (std::log(ends) - std::log(leads)) / (da + db);
+        if (std::fabs(log_beta) * (da + db) > 600.0) log_beta = 0.0; // beta^k would overflow
+    }
+    auto scaled = [log_beta](const Polynomial& p, int d) {
+        Polynomial q(p.begin(), p.begin() + d + 1);
+        if (log_beta != 0.0) {
+            for (int k = 0; k <= d; ++k) q[static_cast<size_t>(k)] *= std::exp(log_beta * k);
+        }
+        return q;
+    };
+    Polynomial sa = scaled(a, da), sb = scaled(b, db);
+    double scale_a = max_magnitude(sa), scale_b = max_magnitude(sb);
+
+    size_t length = sa.size() + sb.size() - 1;
+    size_t n = 1;
+    while (n < length) n <<= 1;
+
+    std::vector<Complex> z(n);
+    for (size_t k = 0; k < sa.size(); ++k) z[k].real(sa[k] / scale_a);
+    for (size_t k = 0; k < sb.size(); ++k) z[k].imag(sb[k] / scale_b);
+    fft(z, false);
+    for (Complex& value : z) value *= value;
+    fft(z, true);
+
+    Polynomial product(length);
+    double factor = scale_a * scale_b / (2.0 * static_cast<double>(n));
+    for (size_t k = 0; k < length; ++k) {
+        product[k] = z[k].imag() * factor;
+        if (log_beta != 0.0) product[k] *= std::exp(-log_beta * static_cast<double>(k));
+    }
+    trim(product);
+    return product;
+}
+
+Polynomial power(const Polynomial& p, int n) {
+    Polynomial result = {1.0};
+    Polynomial base = p;
+    while (n > 0) {
+        if (n & 1) result = multiply(result, base);
+        n >>= 1;
+        if (n > 0) base = multiply(base, base);
+    }
+    return result;
+}
+
+Polynomial product(std::vector<Polynomial> factors) {
+    if (factors.empty()) return {1.0};
+    while (factors.size() > 1) {
+        size_t half = (factors.size() + 1) / 2;
+        for (size_t i = 0; i < factors.size() / 2; ++i) {
+            factors[i] = multiply(factors[2 * i], factors[2 * i + 1]);
+        }
+        if (factors.size() % 2 == 1) factors[half - 1] = std::move(factors.back());
+        factors.resize(half);
+    }
+    return factors[0];
+}
+
+PolynomialDivision divide(const Polynomial& a, const Polynomial& b) {
+    int db = degree(b);
+    if (db < 0) throw std::invalid_argument("Polynomial division by zero.");
+    int da = degree(a);
+    if (da < db) {
+        Polynomial remainder = a;
+        trim(remainder);
+        return {{0.0}, remainder};
+    }
+
+    Polynomial remainder(a.begin(), a.begin() + da + 1);
+    Polynomial quotient(static_cast<size_t>(da - db + 1), 0.0);
+    double leading = b[static_cast<size_t>(db)];
+    for (int k = da - db; k >= 0; --k) {
+        double q = remainder[static_cast<size_t>(k + db)] / leading;
+        quotient[static_cast<size_t>(k)] = q;
+        for (int j = 0; j <= db; ++j) {
+            remainder[static_cast<size_t>(k + j)] -= q * b[static_cast<size_t>(j)];
+        }
+        remainder[static_cast<size_t>(k + db)] = 0.0; // Exactly cancelled
+    }
+    remainder.resize(static_cast<size_t>(std::max(db, 1)));
+    trim(remainder);
+    trim(quotient);
+    return {quotient, remainder};
+}
+
+Polynomial gcd(Polynomial a, Polynomial b, double tolerance) {
+    trim(a);
+    trim(b);
+    if (degree(a) < degree(b)) std::swap(a, b);
+    while (!is_zero(b)) {
+        Polynomial remainder = divide(a, b).remainder;
+        double limit = tolerance * max_magnitude(b);
+        for (double& c : remainder) {
+            if (std::fabs(c) <= limit) c = 0.0;
+        }
+        trim(remainder);
+        a = std::move(b);
+        b = std::move(remainder);
+    }
+
+    int d = degree(a);
+    if (d < 0) return {0.0};
+    double leading = a[static_cast<size_t>(d)];
+    a.resize(static_cast<size_t>(d + 1));
+    for (double& c : a) c /= leading;
+    return a;
+}
+
+Polynomial derivative(const Polynomial& p) {
+    if (p.size() < 2) return {0.0};
+    Polynomial result(p.size() - 1);
+    for (size_t k = 1; k < p.size(); ++k) {
+        result[k - 1] = static_cast<double>(k) * p[k];
+    }
+    trim(result);
+    return result;
+}
+
+Polynomial shift_polynomial(const Polynomial& p, double shift) {
+    // Horner on polynomials: result = (...(p_n u + p_{n-1}) u + ...) with u = s - shift
+    Polynomial result;
+    for (size_t k = p.size(); k-- > 0;) {
+        if (!result.empty()) {
+            result.push_back(0.0);
+            for (size_t j = result.size() - 1; j > 0; --j) {
+                result[j] = result[j - 1] - shift * result[j];
+            }
+            result[0] = -shift * result[0];
+        }
+        if (result.empty()) result.push_back(0.0);
+        result[0] += p[k];
+    }
+    if (result.empty()) result.push_back(0.0);
+    return result;
+}
+
+} // namespace Laplace
@@ -0,0 +1,276 @@
+#include "../include/rational.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <stdexcept>
+
+namespace Laplace {
+
+namespace {
+
+// Two ulps: enough to absorb the rounding of a short product of decimal literals (0.1*3 is
+// one ulp above 0.3), far too tight for a genuinely different fraction to slip in.
+constexpr double kFromDoubleTolerance = 0x1p-51;
+
+// Fractions are tried before decimals, but only with small denominators: two distinct
+// fractions p/q and r/s are at least 1/(qs) apart, so one this simple cannot shadow a
+// decimal of up to nine digits.
+constexpr int64_t kMaxFractionDenominator = int64_t(1) << 20;
+
+// Significant digits of the longest decimal tried
+constexpr int kMaxDecimalDigits = 15;
+
+bool is_representable(int64_t value) {
+    return value != INT64_MIN;
+}
+
+// Exact value of a finite double: m * 2^e with an integral 53-bit m.
+Rational exact_binary_value(double x) {
+    int exponent = 0;
+    double mantissa = std::frexp(x, &exponent);
+    int64_t m = static_cast<int64_t>(std::ldexp(mantissa, 53));
+    exponent -= 53;
+    if (exponent >= 0) return Rational(BigInt(m) * BigInt::power_of_two(static_cast<unsigned>(exponent)), 1);
+    return Rational(BigInt(m), BigInt::power_of_two(static_cast<unsigned>(-exponent)));
+}
+
+Rational power_of_ten(int exponent) {
+    Rational result = 1, base = exponent < 0 ? Rational(1, 10) : Rational(10);
+    for (unsigned n = static_cast<unsigned>(std::abs(exponent)); n > 0; n >>= 1) {
+        if (n & 1) result *= base;
+        if (n > 1) base *= base;
+    }
+    return result;
+}
+
+// The shortest decimal, up to kMaxDecimalDigits significant digits, within tolerance of x.
+bool nearby_decimal(double x, double tolerance, Rational& value) {
+    char text[32];
+    for (int digits = 1; digits <= kMaxDecimalDigits; ++digits) {
+        std::snprintf(text, sizeof text, "%.*e", digits - 1, x);
+        if (std::fabs(std::strtod(text, nullptr) - x) > tolerance) continue;
+        // d.ddd...e+XX: the digits as an integer, scaled by the exponent
+        int64_t mantissa = 0;
+        char* cursor = text;
+        for (; *cursor != 'e'; ++cursor) {
+            if (*cursor >= '0' && *cursor <= '9') mantissa = mantissa * 10 + (*cursor - '0');
+        }
+        int exponent = std::atoi(cursor + 1) - (digits - 1);
+        value = Rational(x < 0 ? -mantissa : mantissa) * power_of_ten(exponent);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+Rational::Rational(int64_t value) {
+    if (is_representable(value)) {
+        numerator_ = value;
+    } else {
+        big_ = std::make_shared<const Big>(Big{BigInt(value), BigInt(1)});
+    }
+}
+
+Rational::Rational(int64_t numerator, int64_t denominator) {
+    if (denominator == 0) throw std::domain_error("Fraction with a zero denominator.");
+    if (!is_representable(numerator) || !is_representable(denominator)) {
+        *this = make_big(BigInt(numerator), BigInt(denominator));
+        return;
+    }
+    if (denominator < 0) {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+    int64_t g = std::gcd(numerator, denominator);
+    numerator_ = numerator / g;
+    denominator_ = denominator / g;
+}
+
+Rational::Rational(const BigInt& numerator, const BigInt& denominator) {
+    if (denominator.is_zero()) throw std::domain_error("Fraction with a zero denominator.");
+    *this = make_big(numerator, denominator);
+}
+
+Rational Rational::make_inline(int64_t numerator, int64_t denominator) {
+    Rational value;
+    value.numerator_ = numerator;
+    value.denominator_ = denominator;
+    return value;
+}
+
+Rational Rational::make_big(BigInt numerator, BigInt denominator) {
+    if (denominator.sign() < 0) {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+    BigInt g = BigInt::gcd(numerator, denominator);
+    if (g != BigInt(1)) {
+        numerator = numerator / g;
+        denominator = denominator / g;
+    }
+    if (numerator.fits_int64() && denominator.fits_int64()) {
+        return make_inline(numerator.to_int64(), denominator.to_int64());
+    }
+    Rational value;
+    value.big_ = std::make_shared<const Big>(Big{std::move(numerator), std::move(denominator)});
+    return value;
+}
+
+Rational Rational::from_double(double x) {
+    if (!std::isfinite(x)) throw std::invalid_argument("Only finite numbers have an exact fraction.");
+    double magnitude = std::fabs(x);
+    if (magnitude == std::floor(magnitude) && magnitude < 0x1p53) return Rational(static_cast<int64_t>(x));
+    const double tolerance = magnitude * kFromDoubleTolerance;
+
+    // Convergents h/k of the continued fraction of |x|, each the best approximation with a
+    // denominator that small: finds 1/3, 2/7 and 0.1/1.5 = 1/15.
+    int64_t h = 1, h_previous = 0, k = 0, k_previous = 1;
+    double rest = magnitude;
+    while (rest < 0x1p62) {
+        int64_t a = static_cast<int64_t>(std::floor(rest));
+        int64_t h_next, k_next;
+        if (__builtin_mul_overflow(a, h, &h_next) || __builtin_add_overflow(h_next, h_previous, &h_next) ||
+            __builtin_mul_overflow(a, k, &k_next) || k_next > kMaxFractionDenominator - k_previous) {
+            break;
+        }
+        k_next += k_previous;
+        h_previous = h;
+        h = h_next;
+        k_previous = k;
+        k = k_next;
+        if (std::fabs(static_cast<double>(h) / static_cast<double>(k) - magnitude) <= tolerance) {
+            return make_inline(x < 0 ? -h : h, k);
+        }
+        double fraction = rest - static_cast<double>(a);
+        if (fraction == 0.0) break;
+        rest = 1.0 / fraction;
+    }
+
+    // Then a decimal literal as typed, including ones like 6.02e23 past the integers
+    Rational decimal;
+    if (nearby_decimal(x, tolerance, decimal)) return decimal;
+    return exact_binary_value(x);
+}
+
+bool Rational::is_integer() const {
+    return big_ ? big_->denominator == BigInt(1) : denominator_ == 1;
+}
+
+int Rational::sign() const {
+    if (big_) return big_->numerator.sign();
+    return (numerator_ > 0) - (numerator_ < 0);
+}
+
+BigInt Rational::numerator() const {
+    return big_ ? big_->numerator : BigInt(numerator_);
+}
+
+BigInt Rational::denominator() const {
+    return big_ ? big_->denominator : BigInt(denominator_);
+}
+
+double Rational::to_double() const {
+    if (!big_) return static_cast<double>(numerator_) / static_cast<double>(denominator_);
+    // Quotient of the mantissas, exponents apart: either part may be past double range
+    long numerator_exponent, denominator_exponent;
+    double numerator_mantissa = big_->numerator.frexp(numerator_exponent);
+    double denominator_mantissa = big_->denominator.frexp(denominator_exponent);
+    long exponent = numerator_exponent - denominator_exponent;
+    if (exponent > 2000) exponent = 2000;
+    if (exponent < -2000) exponent = -2000;
+    return std::ldexp(numerator_mantissa / denominator_mantissa, static_cast<int>(exponent));
+}
+
+Rational Rational::operator-() const {
+    if (!big_) return make_inline(-numerator_, denominator_);
+    return make_big(-big_->numerator, big_->denominator);
+}
+
+Rational Rational::reciprocal() const {
+    if (is_zero()) throw std::domain_error("Reciprocal of zero.");
+    if (!big_) return numerator_ < 0 ? make_inline(-denominator_, -numerator_) : make_inline(denominator_, numerator_);
+    return make_big(big_->denominator, big_->numerator);
+}
+
+Rational operator+(const Rational& a, const Rational& b) {
+    if (!a.big_ && !b.big_) {
+        // a/b + c/d = (a (d/g) + c (b/g)) / (b (d/g)) with g = gcd(b, d), and the result
+        // only shares factors of g with the new numerator (Knuth 4.5.1).
+        int64_t g = std::gcd(a.denominator_, b.denominator_);
+        int64_t a_scale = b.denominator_ / g, b_scale = a.denominator_ / g;
+        int64_t x, y, numerator, denominator;
+        if (!__builtin_mul_overflow(a.numerator_, a_scale, &x) && !__builtin_mul_overflow(b.numerator_, b_scale, &y) &&
+            !__builtin_add_overflow(x, y, &numerator) && is_representable(numerator) &&
+            !__builtin_mul_overflow(a.denominator_, a_scale, &denominator)) {
+            int64_t reduce = std::gcd(numerator, g);
+            return Rational::make_inline(numerator / reduce, denominator / reduce);
+        }
+    }
+    BigInt a_denominator = a.denominator(), b_denominator = b.denominator();
+    return Rational::make_big(a.numerator() * b_denominator + b.numerator() * a_denominator,
+                              a_denominator * b_denominator);
+}
+
+Rational operator-(const Rational& a, const Rational& b) {
+    return a + (-b);
+}
+
+Rational operator*(const Rational& a, const Rational& b) {
+    if (!a.big_ && !b.big_) {
+        // Cross-cancel first, so the products are already in lowest terms
+        int64_t g1 = std::gcd(a.numerator_, b.denominator_);
+        int64_t g2 = std::gcd(b.numerator_, a.denominator_);
+        int64_t numerator, denominator;
+        if (!__builtin_mul_overflow(a.numerator_ / g1, b.numerator_ / g2, &numerator) && is_representable(numerator) &&
+            !__builtin_mul_overflow(a.denominator_ / g2, b.denominator_ / g1, &denominator)) {
+            return Rational::make_inline(numerator, denominator);
+        }
+    }
+    return Rational::make_big(a.numerator() * b.numerator(), a.denominator() * b.denominator());
+}
+
+Rational operator/(const Rational& a, const Rational& b) {
+    return a * b.reciprocal();
+}
+
+int Rational::compare(const Rational& a, const Rational& b) {
+    if (!a.big_ && !b.big_) {
+        __int128 left = static_cast<__int128>(a.numerator_) * b.denominator_;
+        __int128 right = static_cast<__int128>(b.numerator_) * a.denominator_;
+        return (left > right) - (left < right);
+    }
+    return BigInt::compare(a.numerator() * b.denominator(), b.numerator() * a.denominator());
+}
+
+bool operator==(const Rational& a, const Rational& b) {
+    // Both sides are in lowest terms, and a value that fits inline is never stored big
+    if (!a.big_ && !b.big_) return a.numerator_ == b.numerator_ && a.denominator_ == b.denominator_;
+    if (!a.big_ || !b.big_) return false;
+    return a.big_->numerator == b.big_->numerator && a.big_->denominator == b.big_->denominator;
+}
+
+void Rational::append_to(std::string& out) const {
+    if (!big_) {
+        out += std::to_string(numerator_);
+        if (denominator_ != 1) {
+            out += "/";
+            out += std::to_string(denominator_);
+        }
+        return;
+    }
+    big_->numerator.append_to(out);
+    if (big_->denominator != BigInt(1)) {
+        out += "/";
+        big_->denominator.append_to(out);
+    }
+}
+
+std::string Rational::to_string() const {
+    std::string out;
+    append_to(out);
+    return out;
+}
+
+} // namespace Laplace
@@ -0,0 +1,213 @@
+#include "../include/rational_function.h"
+#include "../include/polynomial.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace Laplace {
+
+namespace {
+
+// Index of the only non-zero coefficient, or -1 if p has several (or none).
+int monomial_degree(const std::vector<double>& p) {
+    int degree = -1;
+    for (size_t k = 0; k < p.size(); ++k) {
+        if (p[k] == 0.0) continue;
+        if (degree != -1) return -1;
+        degree = static_cast<int>(k);
+    }
+    return degree;
+}
+
+// "s", "(s - 2)" or "(s + 3)"
+std::string variable_text(double shift, const NumberFormat& format) {
+    if (shift == 0.0) return "s";
+    std::string text = "(s";
+    text += shift > 0.0 ? " - " : " + ";
+    append_number(text, std::fabs(shift), format);
+    text += ")";
+    return text;
+}
+
+void append_power(std::string& out, const std::string& variable, int k) {
+    out += variable;
+    if (k > 1) {
+        out += "^";
+        out += std::to_string(k);
+    }
+}
+
+// variable^exponent for the fractional powers of L{t^nu}, "s^2.5" or "s^0.5"
+void append_real_power(std::string& out, const std::string& variable, double exponent) {
+    out += variable;
+    out += "^";
+    append_number(out, exponent);
+}
+
+// Writes p(u) highest power first, e.g. "(s + 3)^2 + 9" or "s^2 - 16".
+void append_polynomial(std::string& out, const std::vector<double>& p, const std::string& variable,
+                       const NumberFormat& format) {
+    bool first = true;
+    for (size_t k = p.size(); k-- > 0;) {
+        double c = p[k];
+        if (c == 0.0) continue;
+        if (first) {
+            if (c < 0.0) out += "-";
+        } else {
+            out += c < 0.0 ? " - " : " + ";
+        }
+        first = false;
+        c = std::fabs(c);
+        if (k == 0) {
+            append_number(out, c, format);
+            continue;
+        }
+        if (c != 1.0) {
+            append_number(out, c, format);
+            out += "*";
+        }
+        append_power(out, variable, static_cast<int>(k));
+    }
+    if (first) out += "0";
+}
+
+} // namespace
+
+bool RationalFunction::is_zero() const {
+    if (gain == 0.0) return true;
+    for (double c : numerator) {
+        if (c != 0.0) return false;
+    }
+    return true;
+}
+
+std::vector<double> RationalFunction::numerator_in_s() const {
+    if (is_zero()) return {0.0};
+    if (!is_rational()) throw std::domain_error("A fractional power of s has no polynomial form.");
+    double scale = gain * std::exp(log_gain);
+    if (!std::isfinite(scale)) throw std::overflow_error("Gain is beyond double range.");
+    std::vector<double> result = shift_polynomial(numerator, shift);
+    for (double& c : result) c *= scale;
+    return result;
+}
+
+std::vector<double> RationalFunction::denominator_in_s() const {
+    if (!is_rational()) throw std::domain_error("A fractional power of s has no polynomial form.");
+    return Laplace::power(shift_polynomial(denominator, shift), power);
+}
+
+std::complex<double> RationalFunction::evaluate(std::complex<double> s) const {
+    if (is_zero()) return 0.0;
+    std::complex<double> u = s - shift;
+    std::complex<double> n = Laplace::evaluate(numerator, u), d = Laplace::evaluate(denominator, u);
+    if (log_gain == 0.0 && fractional_power == 0.0) return gain * n / std::pow(d, power);
+    // Principal branch of d^(power + fraction); in log form so e^log_gain never overflows alone
+    return gain * std::exp(log_gain + std::log(n) - (power + fractional_power) * std::log(d));
+}
+
+std::string RationalFunction::to_string(const NumberFormat& format) const {
+    std::string out;
+    append_to(out, format);
+    return out;
+}
+
+void RationalFunction::append_to(std::string& out, const NumberFormat& format) const {
+    if (is_zero()) {
+        out += "0";
+        return;
+    }
+
+    std::string variable = variable_text(shift, format);
+
+    // Numerator: a single monomial absorbs the gain ("12*s", "-3/s"), anything longer
+    // keeps it as a factor ("3*(s^2 - 16)").
+    int k = monomial_degree(numerator);
+    if (k >= 0) {
+        double value = gain * numerator[k];
+        if (k == 0) {
+            append_scaled_number(out, value, log_gain, format);
+        } else {
+            if (value == -1.0 && log_gain == 0.0) out += "-";
+            else if (value != 1.0 || log_gain != 0.0) {
+                append_scaled_number(out, value, log_gain, format);
+                out += "*";
+            }
+            append_power(out, variable, k);
+        }
+    } else {
+        if (gain != 1.0 || log_gain != 0.0) {
+            append_scaled_number(out, gain, log_gain, format);
+            out += "*";
+        }
+        out += "(";
+        append_polynomial(out, numerator, variable, format);
+        out += ")";
+    }
+
+    // Denominator: "s^3", "(s - 2)", "((s - 2)^2)", "(s^2 + 4)", "(((s + 3)^2 + 9)^2)"
+    out += "/";
+    int d = monomial_degree(denominator);
+    if (d >= 0 && denominator[d] == 1.0 && !is_rational()) {
+        double exponent = d * (power + fractional_power);
+        if (shift == 0.0) {
+            append_real_power(out, variable, exponent);
+        } else {
+            out += "(";
+            append_real_power(out, variable, exponent);
+            out += ")";
+        }
+    } else if (d >= 0 && denominator[d] == 1.0) {
+        int exponent = d * power;
+        if (shift == 0.0) {
+            append_power(out, variable, exponent);
+        } else if (exponent == 1) {
+            out += variable;
+        } else {
+            out += "(";
+            append_power(out, variable, exponent);
+            out += ")";
+        }
+    } else if (!is_rational()) {
+        out += "((";
+        append_polynomial(out, denominator, variable, format);
+        out += ")^";
+        append_number(out, power + fractional_power);
+        out += ")";
+    } else if (power == 1) {
+        out += "(";
+        append_polynomial(out, denominator, variable, format);
+        out += ")";
+    } else {
+        out += "((";
+        append_polynomial(out, denominator, variable, format);
+        out += ")^";
+        out += std::to_string(power);
+        out += ")";
+    }
+}
+
+void append_sum(std::string& out, const std::vector<RationalFunction>& terms, const NumberFormat& format,
+                Progress* progress) {
+    if (progress) progress->begin_stage(terms.size());
+    for (size_t i = 0; i < terms.size(); ++i) {
+        if (progress) progress->advance();
+        if (i == 0) {
+            terms[i].append_to(out, format);
+            continue;
+        }
+        size_t separator = out.size();
+        out += " + ";
+        terms[i].append_to(out, format);
+        if (out[separator + 3] == '-') {
+            // The sign is already part of the term: " + -3/s" becomes " -3/s"
+            out.erase(separator + 1, 2);
+        }
+    }
+}
+
+std::string to_string(const std::vector<RationalFunction>& terms, const NumberFormat& format) {
+    std::string total;
+    append_sum(total, terms, format);
+    return total;
+}
+
+} // namespace Laplace
@@ -0,0 +1,184 @@
+#include "../include/simplify.h"
+#include "../include/polynomial.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <utility>
+
+namespace Laplace {
+
+namespace {
+
+bool like_less(const ParsedTerm& a, const ParsedTerm& b) {
+    if (a.type != b.type) return a.type < b.type;
+    if (a.parameters.size() != b.parameters.size()) return a.parameters.size() < b.parameters.size();
+    return std::lexicographical_compare(a.parameters.begin(), a.parameters.end(), b.parameters.begin(), b.parameters.end());
+}
+
+bool denominator_less(const RationalFunction& a, const RationalFunction& b) {
+    if (a.power != b.power) return a.power < b.power;
+    if (a.fractional_power != b.fractional_power) return a.fractional_power < b.fractional_power;
+    if (a.log_gain != b.log_gain) return a.log_gain < b.log_gain;
+    if (a.shift != b.shift) return a.shift < b.shift;
+    return a.denominator < b.denominator;
+}
+
+// Indices of items sorted by `less`, equal items in their original order, so each run of
+// equal items starts with the one that came first.
+template <typename T, typename Less>
+std::vector<size_t> stable_order(const std::vector<T>& items, Less less) {
+    std::vector<size_t> order(items.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return less(items[a], items[b]); });
+    return order;
+}
+
+// Calls fn(begin, end) for each run of equal items in `order`.
+template <typename T, typename Less, typename Fn>
+void for_each_run(const std::vector<T>& items, const std::vector<size_t>& order, Less less, Fn fn) {
+    for (size_t begin = 0; begin < order.size();) {
+        size_t end = begin + 1;
+        while (end < order.size() && !less(items[order[begin]], items[order[end]])) ++end;
+        fn(begin, end);
+        begin = end;
+    }
+}
+
+// Results keyed by the index of the first item that produced them, back in input order.
+template <typename T>
+std::vector<T> in_first_order(std::vector<std::pair<size_t, T>>& keyed) {
+    std::sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<T> result;
+    result.reserve(keyed.size());
+    for (auto& entry : keyed) result.push_back(std::move(entry.second));
+    return result;
+}
+
+// N/D as a pair of polynomials in s, for combining fractions.
+struct Fraction {
+    Polynomial numerator;
+    Polynomial denominator;
+};
+
+// Sum of fractions[begin, end) with denominators that share no factor, halving the range
+// each level: both products at each level are about as long as the whole result, so the
+// cost is that of a few full-size multiplications per level rather than one per term.
+Fraction sum_of(std::vector<Fraction>& fractions, size_t begin, size_t end) {
+    if (end - begin == 1) return std::move(fractions[begin]);
+    size_t middle = begin + (end - begin) / 2;
+    Fraction left = sum_of(fractions, begin, middle);
+    Fraction right = sum_of(fractions, middle, end);
+    return {add(multiply(left.numerator, right.denominator), multiply(right.numerator, left.denominator)),
+            multiply(left.denominator, right.denominator)};
+}
+
+RationalFunction zero() {
+    RationalFunction f;
+    f.numerator = {0.0};
+    f.denominator = {1.0};
+    return f;
+}
+
+} // namespace
+
+std::vector<ParsedTerm> merge_like_terms(const std::vector<ParsedTerm>& terms, Progress* progress) {
+    if (progress) progress->begin_stage(terms.size());
+    std::vector<size_t> order = stable_order(terms, like_less);
+    std::vector<std::pair<size_t, ParsedTerm>> merged;
+    for_each_run(terms, order, like_less, [&](size_t begin, size_t end) {
+        if (progress) progress->advance(end - begin);
+        ParsedTerm term = terms[order[begin]];
+        for (size_t k = begin + 1; k < end; ++k) {
+            term.coefficient += terms[order[k]].coefficient;
+        }
+        if (term.coefficient != 0.0) merged.emplace_back(order[begin], term);
+    });
+
+    if (merged.empty() && !terms.empty()) {
+        ParsedTerm cancelled = terms[0];
+        cancelled.coefficient = 0.0;
+        return {cancelled};
+    }
+    return in_first_order(merged);
+}
+
+std::vector<RationalFunction> group_by_denominator(const std::vector<RationalFunction>& transforms, Progress* progress) {
+    if (progress) progress->begin_stage(transforms.size());
+    std::vector<size_t> order = stable_order(transforms, denominator_less);
+    std::vector<std::pair<size_t, RationalFunction>> grouped;
+    for_each_run(transforms, order, denominator_less, [&](size_t begin, size_t end) {
+        if (progress) progress->advance(end - begin);
+        std::vector<size_t> members;
+        for (size_t k = begin; k < end; ++k) {
+            if (!transforms[order[k]].is_zero()) members.push_back(order[k]);
+        }
+        if (members.empty()) return;
+        if (members.size() == 1) {
+            // Alone over its denominator: keep the gain factored out, "3*(s^2 - 16)/..."
+            grouped.emplace_back(members[0], transforms[members[0]]);
+            return;
+        }
+
+        RationalFunction sum = transforms[members[0]];
+        sum.gain = 1.0;
+        sum.numerator.clear();
+        for (size_t i : members) {
+            const RationalFunction& f = transforms[i];
+            if (sum.numerator.size() < f.numerator.size()) sum.numerator.resize(f.numerator.size(), 0.0);
+            for (size_t k = 0; k < f.numerator.size(); ++k) {
+                sum.numerator[k] += f.gain * f.numerator[k];
+            }
+        }
+        trim(sum.numerator);
+        if (!is_zero(sum.numerator)) grouped.emplace_back(members[0], std::move(sum));
+    });
+
+    if (grouped.empty() && !transforms.empty()) return {zero()};
+    return in_first_order(grouped);
+}
+
+RationalFunction common_denominator(const std::vector<RationalFunction>& transforms) {
+    // Distinct factors D(u) by (shift, coefficients), each at its highest power
+    struct Factor {
+        Polynomial in_s; // D(s - shift)
+        int power = 0;
+        std::vector<size_t> terms;
+    };
+    std::vector<Factor> factors;
+    std::map<std::pair<double, std::vector<double>>, size_t> index;
+    for (size_t i = 0; i < transforms.size(); ++i) {
+        const RationalFunction& f = transforms[i];
+        if (f.is_zero()) continue;
+        auto inserted = index.emplace(std::make_pair(f.shift + 0.0, f.denominator), factors.size());
+        if (inserted.second) factors.push_back({shift_polynomial(f.denominator, f.shift), 0, {}});
+        Factor& factor = factors[inserted.first->second];
+        factor.power = std::max(factor.power, f.power);
+        factor.terms.push_back(i);
+    }
+    if (factors.empty()) return zero();
+
+    // One fraction per factor: its terms raised to the factor's full power and added
+    std::vector<Fraction> fractions;
+    fractions.reserve(factors.size());
+    for (const Factor& factor : factors) {
+        Fraction fraction{{0.0}, power(factor.in_s, factor.power)};
+        for (size_t i : factor.terms) {
+            const RationalFunction& f = transforms[i];
+            Polynomial term = f.numerator_in_s();
+            if (f.power < factor.power) term = multiply(term, power(factor.in_s, factor.power - f.power));
+            fraction.numerator = add(fraction.numerator, term);
+        }
+        fractions.push_back(std::move(fraction));
+    }
+
+    Fraction sum = sum_of(fractions, 0, fractions.size());
+    if (is_zero(sum.numerator)) return zero();
+
+    RationalFunction result;
+    result.gain = 1.0;
+    result.numerator = std::move(sum.numerator);
+    result.denominator = std::move(sum.denominator);
+    return result;
+}
+
+} // namespace Laplace
@@ -0,0 +1,62 @@
+#include "../include/special_functions.h"
+#include <cmath>
+
+namespace Laplace {
+
+namespace {
+
+constexpr double kLanczosG = 7.0;
+constexpr double kLanczos[] = {
+    0.99999999999980993,  676.5203681218851,     -1259.1392167224028,
+    771.32342877765313,   -176.61502916214059,   12.507343278686905,
+    -0.13857109526572012, 9.9843695780195716e-6, 1.5056327351493116e-7,
+};
+
+// Lanczos series A(x) for Gamma(x + 1) = sqrt(2 pi) t^(x + 1/2) e^-t A(x), t = x + g + 1/2.
+double lanczos_sum(double x) {
+    double sum = kLanczos[0];
+    for (int i = 1; i < 9; ++i) sum += kLanczos[i] / (x + i);
+    return sum;
+}
+
+bool is_pole(double x) {
+    return x <= 0.0 && x == std::floor(x);
+}
+
+} // namespace
+
+double log_factorial(int n) {
+    if (n < 0) throw std::invalid_argument("Factorial is not defined for negative integers.");
+    if (n <= kMaxFactorial) return std::log(kFactorials[static_cast<size_t>(n)]);
+    return log_gamma(n + 1.0);
+}
+
+double gamma_function(double x) {
+    if (is_pole(x)) return std::numeric_limits<double>::infinity();
+    if (x >= 1.0 && x <= kMaxFactorial + 1.0 && x == std::floor(x)) {
+        return kFactorials[static_cast<size_t>(x) - 1];
+    }
+    if (x < 0.5) {
+        // Gamma(x) Gamma(1 - x) = pi / sin(pi x)
+        return M_PI / (std::sin(M_PI * x) * gamma_function(1.0 - x));
+    }
+    if (x > 171.7) return std::numeric_limits<double>::infinity();
+
+    x -= 1.0;
+    double t = x + kLanczosG + 0.5;
+    // t^(x + 1/2) alone overflows before Gamma does, so it is applied in two halves
+    double half = std::pow(t, 0.5 * (x + 0.5));
+    return std::sqrt(2.0 * M_PI) * half * (half * std::exp(-t)) * lanczos_sum(x);
+}
+
+double log_gamma(double x) {
+    if (is_pole(x)) return std::numeric_limits<double>::infinity();
+    if (x < 0.5) {
+        return std::log(M_PI / std::fabs(std::sin(M_PI * x))) - log_gamma(1.0 - x);
+    }
+    x -= 1.0;
+    double t = x + kLanczosG + 0.5;
+    return 0.5 * std::log(2.0 * M_PI) + (x + 0.5) * std::log(t) - t + std::log(lanczos_sum(x));
+}
+
+} // namespace Laplace
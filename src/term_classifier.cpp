@@ -0,0 +1,267 @@
+#include "../include/term_classifier.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace Laplace {
+
+namespace {
+
+uint64_t bits_of(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    return bits;
+}
+
+// Everything of a product but its coefficient, as bits: products alike in these add up.
+struct ProductKey {
+    uint64_t t_power, a, omega;
+    uint32_t shape;
+
+    explicit ProductKey(const FactorProduct& p)
+        : t_power(bits_of(p.t_power + 0.0)), a(p.has_exp ? bits_of(p.a + 0.0) : 0),
+          omega(p.has_oscillation() ? bits_of(p.omega + 0.0) : 0),
+          shape(static_cast<uint32_t>(p.oscillation) << 1 | (p.has_exp ? 1u : 0u)) {}
+
+    bool operator==(const ProductKey& o) const {
+        return t_power == o.t_power && a == o.a && omega == o.omega && shape == o.shape;
+    }
+
+    size_t hash() const {
+        uint64_t h = shape;
+        for (uint64_t v : {t_power, a, omega}) h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+} // namespace
+
+void TermClassifier::reset(const ExpressionDag& dag, const Progress* progress) {
+    dag_ = &dag;
+    progress_ = progress;
+    // A node with no sum below it takes at most two products plus one per operand
+    max_products_ = kMaxExpandedProducts + 2 * dag.size() + dag.operand_count();
+    products_.clear();
+    results_.clear();
+}
+
+TermClassifier::Range TermClassifier::classify(NodeId node) {
+    if (results_.size() < dag_->size()) results_.resize(dag_->size(), Range{0, kUnclassified});
+    if (results_[node].count == kUnclassified) results_[node] = expand(node);
+    return results_[node];
+}
+
+TermClassifier::Range TermClassifier::append(const FactorProduct& product) {
+    if (products_.size() >= max_products_) throw std::runtime_error("Expression expands to too many terms.");
+    products_.push_back(product);
+    return {products_.size() - 1, 1};
+}
+
+FactorProduct TermClassifier::single(Range range, const char* what) const {
+    if (range.count != 1) throw std::runtime_error(what);
+    return products_[range.first];
+}
+
+// Every product of one from `left` and one from `right`: exponents of t and of e add,
+// and at most one side may carry an oscillation.
+TermClassifier::Range TermClassifier::multiply(Range left, Range right) {
+    if (products_.size() + left.count * right.count > max_products_) {
+        throw std::runtime_error("Expression expands to too many terms.");
+    }
+    size_t first = products_.size();
+    for (size_t i = 0; i < left.count; ++i) {
+        if (progress_) progress_->check(); // A single term may expand to a million products
+        for (size_t j = 0; j < right.count; ++j) {
+            FactorProduct p = products_[left.first + i];
+            const FactorProduct q = products_[right.first + j];
+            p.coefficient *= q.coefficient;
+            p.t_power += q.t_power;
+            if (q.has_exp) {
+                p.a = p.has_exp ? p.a + q.a : q.a;
+                p.has_exp = true;
+            }
+            if (q.has_oscillation()) {
+                if (p.has_oscillation()) {
+                    throw std::runtime_error("Multiple trigonometric/hyperbolic functions in multiplication are not supported.");
+                }
+                p.oscillation = q.oscillation;
+                p.omega = q.omega;
+            }
+            products_.push_back(p);
+        }
+    }
+    return {first, products_.size() - first};
+}
+
+// Adds up the products of `range`, the last in products_, that differ only in their
+// coefficient, keeping the first of each in place, and drops the rest from the end.
+TermClassifier::Range TermClassifier::merge_like(Range range) {
+    size_t slots = 16;
+    while (slots < 2 * range.count) slots <<= 1;
+    merge_slots_.assign(slots, kEmptySlot);
+    const size_t mask = slots - 1;
+    size_t end = range.first;
+    for (size_t i = range.first; i < range.first + range.count; ++i) {
+        const FactorProduct p = products_[i];
+        const ProductKey key(p);
+        for (size_t slot = key.hash() & mask;; slot = (slot + 1) & mask) {
+            uint32_t kept = merge_slots_[slot];
+            if (kept == kEmptySlot) {
+                merge_slots_[slot] = static_cast<uint32_t>(end - range.first);
+                products_[end++] = p;
+                break;
+            }
+            if (ProductKey(products_[range.first + kept]) == key) {
+                products_[range.first + kept].coefficient += p.coefficient;
+                break;
+            }
+        }
+    }
+    products_.resize(end);
+    return {range.first, end - range.first};
+}
+
+TermClassifier::Range TermClassifier::expand(NodeId node) {
+    const ExpressionNode& n = dag_->node(node);
+    const NodeId* operands = dag_->operands(node);
+    switch (n.kind) {
+        case ExpressionKind::NUMBER: {
+            FactorProduct p;
+            p.coefficient = n.value;
+            return append(p);
+        }
+        case ExpressionKind::VARIABLE: {
+            FactorProduct p;
+            p.t_power = 1.0;
+            return append(p);
+        }
+        case ExpressionKind::SUM: {
+            // Operands first, as they may add products of their own; then one contiguous copy
+            size_t total = 0;
+            for (uint32_t i = 0; i < n.count; ++i) total += classify(operands[i]).count;
+            if (products_.size() + total > max_products_) throw std::runtime_error("Expression expands to too many terms.");
+            size_t first = products_.size();
+            for (uint32_t i = 0; i < n.count; ++i) {
+                Range r = results_[operands[i]];
+                for (size_t k = 0; k < r.count; ++k) products_.push_back(products_[r.first + k]);
+            }
+            return {first, total};
+        }
+        case ExpressionKind::NEGATE: {
+            Range r = classify(operands[0]);
+            size_t first = products_.size();
+            for (size_t k = 0; k < r.count; ++k) {
+                FactorProduct p = products_[r.first + k];
+                p.coefficient *= -1.0;
+                append(p);
+            }
+            return {first, r.count};
+        }
+        case ExpressionKind::PRODUCT: {
+            // Left to right from 1, so the coefficient is rounded as written
+            Range result = append(FactorProduct());
+            for (uint32_t i = 0; i < n.count; ++i) result = merge_like(multiply(result, classify(operands[i])));
+            return result;
+        }
+        case ExpressionKind::RECIPROCAL: {
+            FactorProduct p = single(classify(operands[0]), "Division by a sum is not supported.");
+            if (p.has_oscillation()) {
+                throw std::runtime_error("Division by a trigonometric/hyperbolic function is not supported.");
+            }
+            if (p.coefficient == 0.0) throw std::runtime_error("Division by zero.");
+            p.coefficient = 1.0 / p.coefficient;
+            p.t_power = 0.0 - p.t_power;
+            if (p.has_exp) p.a = 0.0 - p.a;
+            return append(p);
+        }
+        case ExpressionKind::POWER:
+            return classify_power(operands[0], operands[1]);
+        default:
+            return classify_function(n.kind, operands[0]);
+    }
+}
+
+TermClassifier::Range TermClassifier::classify_power(NodeId base, NodeId exponent) {
+    Range x = classify(exponent);
+    // e^ without parentheses, which the parser leaves as a power of the number e
+    bool base_is_e = dag_->node(base).kind == ExpressionKind::NUMBER && dag_->node(base).value == M_E;
+    if (x.count != 1 || !products_[x.first].is_constant()) {
+        if (base_is_e) return classify_function(ExpressionKind::EXP, exponent); // e^-t is exp(-t)
+        throw std::runtime_error("Exponents must be constants.");
+    }
+    if (base_is_e) {
+        // e^2 could be the number or, as e^(2) and exp(2) are, exp(2*t)
+        throw std::runtime_error("An exponent of e without t needs parentheses: e^(2) is exp(2*t).");
+    }
+    double p = products_[x.first].coefficient;
+
+    Range b = classify(base);
+    if (b.count == 1 && !products_[b.first].has_oscillation()) {
+        // (c t^n e^(at))^p = c^p t^(np) e^(apt)
+        FactorProduct f = products_[b.first];
+        double coefficient = std::pow(f.coefficient, p);
+        if (!std::isfinite(coefficient)) throw std::runtime_error("Power of a constant is not a finite real number.");
+        f.coefficient = coefficient;
+        f.t_power = f.t_power * p + 0.0;
+        if (f.has_exp) f.a *= p;
+        return append(f);
+    }
+    if (p != std::floor(p) || p < 0.0 || p > kMaxExpandedPower) {
+        throw std::runtime_error("Only whole powers up to 64 of a sum or of sin/cos/sinh/cosh can be expanded.");
+    }
+    // Like products merged after every step, so (t + 1)^n stays at n + 1 products, not 2^n
+    Range result = append(FactorProduct());
+    for (int k = 0; k < static_cast<int>(p); ++k) result = merge_like(multiply(result, b));
+    return result;
+}
+
+TermClassifier::Range TermClassifier::classify_function(ExpressionKind kind, NodeId argument) {
+    Range r = classify(argument);
+    bool linear = false;
+    double omega = 0.0, offset = 0.0;
+    for (size_t k = 0; k < r.count; ++k) {
+        const FactorProduct& q = products_[r.first + k];
+        if (q.is_constant()) {
+            offset += q.coefficient;
+        } else if (q.t_power == 1.0 && !q.has_exp && !q.has_oscillation()) {
+            omega += q.coefficient;
+            linear = true;
+        } else {
+            throw std::runtime_error("Function arguments must be linear in t, like 2*t or 3*t + 1.");
+        }
+    }
+    if (!linear) {
+        omega = offset; // Shorthand: sin(2) is sin(2*t)
+        offset = 0.0;
+    }
+
+    FactorProduct p;
+    if (kind == ExpressionKind::EXP) {
+        p.has_exp = true;
+        p.a = omega;
+        if (offset != 0.0) p.coefficient = std::exp(offset);
+        return append(p);
+    }
+
+    p.oscillation = kind;
+    p.omega = omega;
+    if (offset == 0.0) return append(p);
+
+    // Angle addition: the offset becomes a second term in the companion function
+    FactorProduct q = p;
+    bool trig = kind == ExpressionKind::SIN || kind == ExpressionKind::COS;
+    double c = trig ? std::cos(offset) : std::cosh(offset);
+    double s = trig ? std::sin(offset) : std::sinh(offset);
+    p.coefficient = c;
+    switch (kind) {
+        case ExpressionKind::SIN: q.oscillation = ExpressionKind::COS; q.coefficient = s; break;
+        case ExpressionKind::COS: q.oscillation = ExpressionKind::SIN; q.coefficient = -s; break;
+        case ExpressionKind::SINH: q.oscillation = ExpressionKind::COSH; q.coefficient = s; break;
+        default: q.oscillation = ExpressionKind::SINH; q.coefficient = s; break;
+    }
+    Range result = append(p);
+    append(q);
+    return {result.first, 2};
+}
+
+} // namespace Laplace
@@ -0,0 +1,322 @@
+#include "../include/time_function.h"
+#include "../include/parser.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace Laplace {
+
+namespace {
+
+// Points per block in evaluate(): the stack is stack_depth rows of this many values.
+const size_t kBlock = 64;
+
+// Largest exponent compiled to repeated multiplication.
+const double kMaxIntegerPower = 64.0;
+
+double integer_power(double x, double exponent) {
+    long long n = static_cast<long long>(std::fabs(exponent));
+    double result = 1.0;
+    double base = x;
+    while (n > 0) {
+        if (n & 1) result *= base;
+        n >>= 1;
+        if (n > 0) base *= base;
+    }
+    return exponent < 0.0 ? 1.0 / result : result;
+}
+
+} // namespace
+
+// Recursive descent straight to postfix code. A complete operand whose last instruction is
+// a Constant is exactly that constant, which is what constant folding relies on.
+// Every recursive path passes through unary(), which bounds the nesting at kMaxNesting.
+class TimeFunction::Compiler {
+public:
+    Compiler(std::string_view input, TimeFunction& target) : target_(target) {
+        tokenize(input, tokens_);
+    }
+
+    void compile() {
+        expression();
+        if (current().type != TokenType::END_OF_INPUT) {
+            throw std::runtime_error("Unexpected token in expression in t: " + std::string(current().text));
+        }
+        if (target_.code_.empty()) {
+            throw std::runtime_error("Empty expression in t.");
+        }
+    }
+
+private:
+    static constexpr int kMaxNesting = 200; // As Parser::kMaxDepth
+
+    TimeFunction& target_;
+    std::vector<TokenView> tokens_; // Always ends with END_OF_INPUT
+    size_t index_ = 0;
+    size_t depth_ = 0; // Of the evaluation stack
+    int nesting_ = 0;  // Of unary() calls in progress
+
+    const TokenView& current() const {
+        return tokens_[index_];
+    }
+
+    std::vector<Instruction>& code() {
+        return target_.code_;
+    }
+
+    void push(Op op, double operand = 0.0) {
+        code().push_back({op, operand});
+        ++depth_;
+        target_.stack_depth_ = std::max(target_.stack_depth_, depth_);
+    }
+
+    bool ends_with_constant(size_t count) const {
+        const std::vector<Instruction>& c = target_.code_;
+        if (c.size() < count) return false;
+        return std::all_of(c.end() - count, c.end(), [](const Instruction& i) { return i.op == Op::Constant; });
+    }
+
+    void unary_op(Op op) {
+        if (ends_with_constant(1)) {
+            double& value = code().back().operand;
+            value = apply(op, value, 0.0);
+            return;
+        }
+        code().push_back({op, 0.0});
+    }
+
+    void binary_op(Op op) {
+        if (ends_with_constant(2)) {
+            double right = code().back().operand;
+            code().pop_back();
+            double& left = code().back().operand;
+            left = apply(op, left, right);
+        } else if (op == Op::Power && ends_with_constant(1) && code().back().operand == std::floor(code().back().operand) &&
+                   std::fabs(code().back().operand) <= kMaxIntegerPower) {
+            double exponent = code().back().operand;
+            code().pop_back();
+            code().push_back({Op::IntegerPower, exponent});
+        } else {
+            code().push_back({op, 0.0});
+        }
+        --depth_;
+    }
+
+    static double apply(Op op, double x, double y) {
+        switch (op) {
+            case Op::Add: return x + y;
+            case Op::Subtract: return x - y;
+            case Op::Multiply: return x * y;
+            case Op::Divide: return x / y;
+            case Op::Power: return std::pow(x, y);
+            case Op::IntegerPower: return integer_power(x, y);
+            case Op::Negate: return -x;
+            case Op::Sin: return std::sin(x);
+            case Op::Cos: return std::cos(x);
+            case Op::Tan: return std::tan(x);
+            case Op::Sinh: return std::sinh(x);
+            case Op::Cosh: return std::cosh(x);
+            case Op::Tanh: return std::tanh(x);
+            case Op::Exp: return std::exp(x);
+            case Op::Sqrt: return std::sqrt(x);
+            case Op::Log: return std::log(x);
+            case Op::Abs: return std::fabs(x);
+            default: return x;
+        }
+    }
+
+    void expression() {
+        term();
+        while (current().type == TokenType::PLUS || current().type == TokenType::MINUS) {
+            Op op = current().type == TokenType::PLUS ? Op::Add : Op::Subtract;
+            ++index_;
+            term();
+            binary_op(op);
+        }
+    }
+
+    void term() {
+        unary();
+        for (;;) {
+            TokenType type = current().type;
+            if (type == TokenType::MULTIPLY || type == TokenType::DIVIDE) {
+                ++index_;
+                unary();
+                binary_op(type == TokenType::MULTIPLY ? Op::Multiply : Op::Divide);
+            } else if (type == TokenType::IDENTIFIER || type == TokenType::LPAREN) {
+                power();
+                binary_op(Op::Multiply);
+            } else {
+                return;
+            }
+        }
+    }
+
+    void unary() {
+        if (++nesting_ > kMaxNesting) throw std::runtime_error("Expression in t is nested too deeply.");
+        if (current().type == TokenType::MINUS) {
+            ++index_;
+            unary();
+            unary_op(Op::Negate);
+        } else if (current().type == TokenType::PLUS) {
+            ++index_;
+            unary();
+        } else {
+            power();
+        }
+        --nesting_;
+    }
+
+    void power() {
+        bool base_is_e = current().type == TokenType::IDENTIFIER && current().text == "e";
+        if (base_is_e && tokens_[index_ + 1].type == TokenType::POWER && tokens_[index_ + 2].type == TokenType::LPAREN) {
+            // e^(x) is exp(x), sin(2)-style shorthand included, as in Parser
+            index_ += 2;
+            function("exp");
+            base_is_e = false;
+        } else {
+            primary();
+        }
+        if (current().type != TokenType::POWER) return;
+        ++index_;
+        if (base_is_e) {
+            // e^x is exp(x): drop the pushed e and apply Exp to the exponent
+            code().pop_back();
+            --depth_;
+            unary();
+            unary_op(Op::Exp);
+        } else {
+            unary();
+            binary_op(Op::Power);
+        }
+    }
+
+    void primary() {
+        const TokenView& token = current();
+        switch (token.type) {
+            case TokenType::NUMBER:
+                ++index_;
+                push(Op::Constant, token.value);
+                return;
+            case TokenType::IDENTIFIER:
+                ++index_;
+                if (token.text == "t") {
+                    push(Op::Time);
+                } else if (token.text == "pi" || token.text == "PI") {
+                    push(Op::Constant, M_PI);
+                } else if (token.text == "e") {
+                    push(Op::Constant, M_E);
+                } else {
+                    function(token.text);
+                }
+                return;
+            case TokenType::LPAREN:
+                ++index_;
+                expression();
+                expect(TokenType::RPAREN, ")");
+                return;
+            case TokenType::END_OF_INPUT:
+                throw std::runtime_error("Unexpected end of expression in t.");
+            default:
+                throw std::runtime_error("Unexpected token in expression in t: " + std::string(token.text));
+        }
+    }
+
+    // `frequency`: a constant argument is a multiple of t, as the transform table's functions
+    // read it in Parser, so sin(2) is sin(2t) whichever path solves the line.
+    void function(std::string_view name) {
+        static const struct { const char* name; Op op; bool frequency; } kFunctions[] = {
+            {"sin", Op::Sin, true}, {"cos", Op::Cos, true}, {"tan", Op::Tan, false},
+            {"sinh", Op::Sinh, true}, {"cosh", Op::Cosh, true}, {"tanh", Op::Tanh, false},
+            {"exp", Op::Exp, true}, {"sqrt", Op::Sqrt, false}, {"log", Op::Log, false}, {"ln", Op::Log, false},
+            {"abs", Op::Abs, false},
+        };
+        for (const auto& entry : kFunctions) {
+            if (name != entry.name) continue;
+            expect(TokenType::LPAREN, "(");
+            expression();
+            expect(TokenType::RPAREN, ")");
+            if (entry.frequency && ends_with_constant(1)) {
+                push(Op::Time);
+                binary_op(Op::Multiply);
+            }
+            unary_op(entry.op);
+            return;
+        }
+        throw std::runtime_error("Unknown identifier in expression in t: " + std::string(name));
+    }
+
+    void expect(TokenType type, const char* text) {
+        if (current().type != type) {
+            throw std::runtime_error(std::string("Expected '") + text + "' in expression in t.");
+        }
+        ++index_;
+    }
+};
+
+TimeFunction::TimeFunction(std::string_view expression) {
+    Compiler(expression, *this).compile();
+}
+
+double TimeFunction::operator()(double t) const {
+    double value = 0.0;
+    evaluate(&t, &value, 1);
+    return value;
+}
+
+void TimeFunction::evaluate(const double* t, double* out, size_t count) const {
+    std::vector<double> stack(stack_depth_ * kBlock);
+
+    for (size_t begin = 0; begin < count; begin += kBlock) {
+        const size_t n = std::min(kBlock, count - begin);
+        size_t depth = 0;
+
+        for (const Instruction& instruction : code_) {
+            if (instruction.op == Op::Constant) {
+                std::fill_n(&stack[depth++ * kBlock], n, instruction.operand);
+                continue;
+            }
+            if (instruction.op == Op::Time) {
+                std::copy_n(t + begin, n, &stack[depth++ * kBlock]);
+                continue;
+            }
+
+            double* x = &stack[(depth - 1) * kBlock];
+            switch (instruction.op) {
+                case Op::Add:
+                case Op::Subtract:
+                case Op::Multiply:
+                case Op::Divide:
+                case Op::Power: {
+                    const double* y = x;
+                    x = &stack[(--depth - 1) * kBlock];
+                    switch (instruction.op) {
+                        case Op::Add:      for (size_t i = 0; i < n; ++i) x[i] += y[i]; break;
+                        case Op::Subtract: for (size_t i = 0; i < n; ++i) x[i] -= y[i]; break;
+                        case Op::Multiply: for (size_t i = 0; i < n; ++i) x[i] *= y[i]; break;
+                        case Op::Divide:   for (size_t i = 0; i < n; ++i) x[i] /= y[i]; break;
+                        default:           for (size_t i = 0; i < n; ++i) x[i] = std::pow(x[i], y[i]); break;
+                    }
+                    break;
+                }
+                case Op::IntegerPower: for (size_t i = 0; i < n; ++i) x[i] = integer_power(x[i], instruction.operand); break;
+                case Op::Negate:       for (size_t i = 0; i < n; ++i) x[i] = -x[i]; break;
+                case Op::Sin:          for (size_t i = 0; i < n; ++i) x[i] = std::sin(x[i]); break;
+                case Op::Cos:          for (size_t i = 0; i < n; ++i) x[i] = std::cos(x[i]); break;
+                case Op::Tan:          for (size_t i = 0; i < n; ++i) x[i] = std::tan(x[i]); break;
+                case Op::Sinh:         for (size_t i = 0; i < n; ++i) x[i] = std::sinh(x[i]); break;
+                case Op::Cosh:         for (size_t i = 0; i < n; ++i) x[i] = std::cosh(x[i]); break;
+                case Op::Tanh:         for (size_t i = 0; i < n; ++i) x[i] = std::tanh(x[i]); break;
+                case Op::Exp:          for (size_t i = 0; i < n; ++i) x[i] = std::exp(x[i]); break;
+                case Op::Sqrt:         for (size_t i = 0; i < n; ++i) x[i] = std::sqrt(x[i]); break;
+                case Op::Log:          for (size_t i = 0; i < n; ++i) x[i] = std::log(x[i]); break;
+                case Op::Abs:          for (size_t i = 0; i < n; ++i) x[i] = std::fabs(x[i]); break;
+                default: break;
+            }
+        }
+        std::copy_n(stack.data(), n, out + begin);
+    }
+}
+
+} // namespace Laplace
@@ -0,0 +1,54 @@
+#include "../include/transform_cache.h"
+#include <cstdint>
+#include <cstring>
+
+namespace Laplace {
+
+TermKey::TermKey(const ParsedTerm& term) : type(term.type), parameter_count(term.parameters.size()) {
+    for (size_t i = 0; i < parameter_count; ++i) {
+        parameters[i] = term.parameters[i] + 0.0; // Folds -0.0 into 0.0
+    }
+}
+
+bool TermKey::operator==(const TermKey& other) const {
+    if (type != other.type || parameter_count != other.parameter_count) return false;
+    for (size_t i = 0; i < parameter_count; ++i) {
+        if (parameters[i] != other.parameters[i]) return false;
+    }
+    return true;
+}
+
+size_t TermKeyHash::operator()(const TermKey& key) const {
+    // FNV-1a over the family and the bit patterns of the parameters
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](uint64_t value) {
+        h ^= value;
+        h *= 1099511628211ull;
+    };
+    mix(static_cast<uint64_t>(key.type));
+    for (size_t i = 0; i < key.parameter_count; ++i) {
+        uint64_t bits;
+        std::memcpy(&bits, &key.parameters[i], sizeof(bits));
+        mix(bits);
+    }
+    return static_cast<size_t>(h);
+}
+
+TransformCache::TransformCache(size_t capacity, size_t shard_count) : cache_(capacity, shard_count) {}
+
+RationalFunction TransformCache::transform(const ParsedTerm& term) {
+    if (term.coefficient == 0.0) return {};
+
+    TermKey key(term);
+    RationalFunction result;
+    if (!cache_.find(key, result)) {
+        ParsedTerm unit = term;
+        unit.coefficient = 1.0;
+        result = transform_term(unit); // Throws for bad terms, which are never cached
+        cache_.insert(key, result);
+    }
+    result.gain *= term.coefficient;
+    return result;
+}
+
+} // namespace Laplace
@@ -0,0 +1,168 @@
+#include "../include/transform_registry.h"
+#include "../include/laplace_transforms.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace Laplace {
+
+namespace {
+
+constexpr FunctionType kNone = FunctionType::UNRECOGNIZED;
+
+// Indexed by FunctionType; the static_assert below keeps rows and enum in step.
+constexpr TransformEntry kRegistry[] = {
+    {FunctionType::UNRECOGNIZED, 0, "unrecognized", "unrecognized_function", {0.0, false, kNone}, nullptr},
+    {FunctionType::CONSTANT, 0, "constant", "constant", {0.0, false, kNone},
+        [](const double*, double c) { return transform_constant(c); }},
+    {FunctionType::T_POW_N, 1, "t^n", "t^{n}", {kAnyPower, false, kNone},
+        [](const double* p, double c) { return transform_t_pow(p[0], c); }},
+    {FunctionType::SIN, 1, "sin", "sin({0}*t)", {0.0, false, FunctionType::SIN},
+        [](const double* p, double c) { return transform_sin(p[0], c); }},
+    {FunctionType::COS, 1, "cos", "cos({0}*t)", {0.0, false, FunctionType::COS},
+        [](const double* p, double c) { return transform_cos(p[0], c); }},
+    {FunctionType::EXP, 1, "exp", "exp({0}*t)", {0.0, true, kNone},
+        [](const double* p, double c) { return transform_exp(p[0], c); }},
+    {FunctionType::SINH, 1, "sinh", "sinh({0}*t)", {0.0, false, FunctionType::SINH},
+        [](const double* p, double c) { return transform_sinh(p[0], c); }},
+    {FunctionType::COSH, 1, "cosh", "cosh({0}*t)", {0.0, false, FunctionType::COSH},
+        [](const double* p, double c) { return transform_cosh(p[0], c); }},
+    {FunctionType::T_EXP, 1, "t*exp", "t*exp({0}*t)", {1.0, true, kNone},
+        [](const double* p, double c) { return transform_t_exp(p[0], c); }},
+    {FunctionType::T_SIN, 1, "t*sin", "t*sin({0}*t)", {1.0, false, FunctionType::SIN},
+        [](const double* p, double c) { return transform_t_sin(p[0], c); }},
+    {FunctionType::T_COS, 1, "t*cos", "t*cos({0}*t)", {1.0, false, FunctionType::COS},
+        [](const double* p, double c) { return transform_t_cos(p[0], c); }},
+    {FunctionType::EXP_SIN, 2, "exp*sin", "exp({0}*t)*sin({1}*t)", {0.0, true, FunctionType::SIN},
+        [](const double* p, double c) { return transform_exp_sin(p[0], p[1], c); }},
+    {FunctionType::EXP_COS, 2, "exp*cos", "exp({0}*t)*cos({1}*t)", {0.0, true, FunctionType::COS},
+        [](const double* p, double c) { return transform_exp_cos(p[0], p[1], c); }},
+    {FunctionType::T_SINH, 1, "t*sinh", "t*sinh({0}*t)", {1.0, false, FunctionType::SINH},
+        [](const double* p, double c) { return transform_t_sinh(p[0], c); }},
+    {FunctionType::T_COSH, 1, "t*cosh", "t*cosh({0}*t)", {1.0, false, FunctionType::COSH},
+        [](const double* p, double c) { return transform_t_cosh(p[0], c); }},
+    {FunctionType::EXP_SINH, 2, "exp*sinh", "exp({0}*t)*sinh({1}*t)", {0.0, true, FunctionType::SINH},
+        [](const double* p, double c) { return transform_exp_sinh(p[0], p[1], c); }},
+    {FunctionType::EXP_COSH, 2, "exp*cosh", "exp({0}*t)*cosh({1}*t)", {0.0, true, FunctionType::COSH},
+        [](const double* p, double c) { return transform_exp_cosh(p[0], p[1], c); }},
+    {FunctionType::T_EXP_SIN, 2, "t*exp*sin", "t*exp({0}*t)*sin({1}*t)", {1.0, true, FunctionType::SIN},
+        [](const double* p, double c) { return transform_t_exp_sin(p[0], p[1], c); }},
+    {FunctionType::T_EXP_COS, 2, "t*exp*cos", "t*exp({0}*t)*cos({1}*t)", {1.0, true, FunctionType::COS},
+        [](const double* p, double c) { return transform_t_exp_cos(p[0], p[1], c); }},
+    {FunctionType::T_EXP_SINH, 2, "t*exp*sinh", "t*exp({0}*t)*sinh({1}*t)", {1.0, true, FunctionType::SINH},
+        [](const double* p, double c) { return transform_t_exp_sinh(p[0], p[1], c); }},
+    {FunctionType::T_EXP_COSH, 2, "t*exp*cosh", "t*exp({0}*t)*cosh({1}*t)", {1.0, true, FunctionType::COSH},
+        [](const double* p, double c) { return transform_t_exp_cosh(p[0], p[1], c); }},
+    {FunctionType::T_N_EXP, 2, "t^n*exp", "t^{n}*exp({1}*t)", {kAnyPower, true, kNone},
+        [](const double* p, double c) { return transform_t_n_exp_osc(p[0], p[1], kNone, 0.0, c); }},
+    {FunctionType::T_N_SIN, 2, "t^n*sin", "t^{n}*sin({1}*t)", {kAnyPower, false, FunctionType::SIN},
+        [](const double* p, double c) { return transform_t_n_exp_osc(p[0], 0.0, FunctionType::SIN, p[1], c); }},
+    {FunctionType::T_N_COS, 2, "t^n*cos", "t^{n}*cos({1}*t)", {kAnyPower, false, FunctionType::COS},
+        [](const double* p, double c) { return transform_t_n_exp_osc(p[0], 0.0, FunctionType::COS, p[1], c); }},
+    {FunctionType::T_N_SINH, 2, "t^n*sinh", "t^{n}*sinh({1}*t)", {kAnyPower, false, FunctionType::SINH},
+        [](const double* p, double c) { return transform_t_n_exp_osc(p[0], 0.0, FunctionType::SINH, p[1], c); }},
+    {FunctionType::T_N_COSH, 2, "t^n*cosh", "t^{n}*cosh({1}*t)", {kAnyPower, false, FunctionType::COSH},
+        [](const double* p, double c) { return transform_t_n_exp_osc(p[0], 0.0, FunctionType::COSH, p[1], c); }},
+    {FunctionType::T_N_EXP_SIN, 3, "t^n*exp*sin", "t^{n}*exp({1}*t)*sin({2}*t)", {kAnyPower, true, FunctionType::SIN},
+        [](const double* p, double c) { return transform_t_n_exp_osc(p[0], p[1], FunctionType::SIN, p[2], c); }},
+    {FunctionType::T_N_EXP_COS, 3, "t^n*exp*cos", "t^{n}*exp({1}*t)*cos({2}*t)", {kAnyPower, true, FunctionType::COS},
+        [](const double* p, double c) { return transform_t_n_exp_osc(p[0], p[1], FunctionType::COS, p[2], c); }},
+    {FunctionType::T_N_EXP_SINH, 3, "t^n*exp*sinh", "t^{n}*exp({1}*t)*sinh({2}*t)", {kAnyPower, true, FunctionType::SINH},
+        [](const double* p, double c) { return transform_t_n_exp_osc(p[0], p[1], FunctionType::SINH, p[2], c); }},
+    {FunctionType::T_N_EXP_COSH, 3, "t^n*exp*cosh", "t^{n}*exp({1}*t)*cosh({2}*t)", {kAnyPower, true, FunctionType::COSH},
+        [](const double* p, double c) { return transform_t_n_exp_osc(p[0], p[1], FunctionType::COSH, p[2], c); }},
+    {FunctionType::UNKNOWN_COMPOUND, 0, "compound", "unrecognized_function", {0.0, false, kNone}, nullptr},
+};
+
+constexpr size_t kRegistrySize = sizeof(kRegistry) / sizeof(kRegistry[0]);
+
+constexpr bool registry_is_indexed() {
+    for (size_t i = 0; i < kRegistrySize; ++i) {
+        if (static_cast<size_t>(kRegistry[i].type) != i) return false;
+    }
+    return true;
+}
+static_assert(registry_is_indexed(), "kRegistry rows must follow the FunctionType order");
+static_assert(kRegistrySize == static_cast<size_t>(FunctionType::UNKNOWN_COMPOUND) + 1,
+              "every FunctionType needs a kRegistry row");
+
+} // namespace
+
+const TransformEntry& transform_entry(FunctionType type) {
+    size_t index = static_cast<size_t>(type);
+    return kRegistry[index < kRegistrySize ? index : 0];
+}
+
+const TransformEntry* find_product_family(double t_power, bool has_exp, FunctionType oscillation) {
+    // A row with this exact power of t wins over one that takes any power as a parameter
+    const TransformEntry* any_power = nullptr;
+    for (const TransformEntry& entry : kRegistry) {
+        if (!entry.handler) continue;
+        const FactorSignature& signature = entry.signature;
+        if (signature.has_exp != has_exp || signature.oscillation != oscillation) continue;
+        if (signature.t_power == t_power) return &entry;
+        if (signature.t_power == kAnyPower && !any_power) any_power = &entry;
+    }
+    return any_power;
+}
+
+const TransformEntry& checked_entry(const ParsedTerm& term) {
+    const TransformEntry& entry = transform_entry(term.type);
+    if (!entry.handler) {
+        throw std::runtime_error("Unrecognized term: " + std::string(term.original_term_str));
+    }
+    if (term.parameters.size() < entry.arity) {
+        throw std::runtime_error(std::string("Missing parameters for ") + entry.name);
+    }
+    return entry;
+}
+
+RationalFunction transform_term(const ParsedTerm& term) {
+    const TransformEntry& entry = checked_entry(term);
+    return entry.handler(term.parameters.begin(), term.coefficient);
+}
+
+double evaluate_term(const ParsedTerm& term, double t) {
+    const FactorSignature& signature = checked_entry(term).signature;
+    size_t next = 0;
+    double value = term.coefficient;
+
+    double n = signature.t_power == kAnyPower ? term.parameters[next++] : signature.t_power;
+    if (n != 0.0) value *= std::pow(t, n);
+    if (signature.has_exp) value *= std::exp(term.parameters[next++] * t);
+
+    switch (signature.oscillation) {
+        case FunctionType::SIN: value *= std::sin(term.parameters[next] * t); break;
+        case FunctionType::COS: value *= std::cos(term.parameters[next] * t); break;
+        case FunctionType::SINH: value *= std::sinh(term.parameters[next] * t); break;
+        case FunctionType::COSH: value *= std::cosh(term.parameters[next] * t); break;
+        default: break;
+    }
+    return value;
+}
+
+} // namespace Laplace
+
+// Lives with the registry because the text form is one of its columns.
+std::string ParsedTerm::text_representation() const {
+    const Laplace::TransformEntry& entry = Laplace::transform_entry(type);
+    if (!entry.handler) return entry.pattern;
+
+    std::string text;
+    for (const char* c = entry.pattern; *c != '\0'; ++c) {
+        if (*c != '{') {
+            text += *c;
+            continue;
+        }
+        char field = c[1];
+        c += 2; // Skip the field and its closing '}'
+        if (field == 'n' && parameters[0] == std::floor(parameters[0])) {
+            text += std::to_string(static_cast<long long>(parameters[0]));
+        } else if (field == 'n') {
+            text += std::to_string(parameters[0]);
+        } else {
+            text += std::to_string(parameters[static_cast<size_t>(field - '0')]);
+        }
+    }
+    return text;
+}
@@ -0,0 +1,32 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cmath>
+#include <iostream>
+
+// A failed CHECK prints where and what, and the run carries on; main() returns non-zero
+// if any failed.
+inline int& check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            ++check_failures();                                                           \
+        }                                                                                 \
+    } while (0)
+
+// |actual - expected| within `tolerance` of |expected|, or of 1 near zero.
+inline bool close_to(double actual, double expected, double tolerance = 1e-12) {
+    return std::fabs(actual - expected) <= tolerance * std::fmax(1.0, std::fabs(expected));
+}
+
+// One per test file, called from main().
+void run_parser_tests();
+void run_transform_tests();
+void run_constexpr_laplace_tests();
+
+#endif // CHECK_H
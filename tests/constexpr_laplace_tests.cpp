@@ -0,0 +1,85 @@
+#include "check.h"
+#include "constexpr_laplace.h"
+#include "parser.h"
+#include "transform_registry.h"
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+namespace ct = Laplace::ct;
+
+// Evaluated by the compiler: each value is the table's formula worked out by hand.
+// L{t^2 e^-3t} = 2/(s + 3)^3
+constexpr auto kTSquaredExp = ct::laplace("t^2*exp(-3t)");
+static_assert(kTSquaredExp.size == 1, "one term");
+static_assert(kTSquaredExp.terms[0].gain == 2.0 && kTSquaredExp.terms[0].power == 3, "2!/u^3");
+static_assert(kTSquaredExp.terms[0].shift == -3.0, "u = s + 3");
+static_assert(kTSquaredExp.evaluate(1.0) == 2.0 / 64.0, "2/(1 + 3)^3");
+
+// L{3 e^-2t sin 5t} = 15/((s + 2)^2 + 25)
+constexpr auto kDampedSine = ct::laplace("3*exp(-2*t)*sin(5*t)");
+static_assert(kDampedSine.evaluate(-2.0) == 15.0 / 25.0, "u = 0");
+
+// L{t^3 + 4 cos 2t} = 6/s^4 + 4s/(s^2 + 4)
+constexpr auto kSum = ct::laplace("t^3 + 4*cos(2t)");
+static_assert(kSum.size == 2, "two terms");
+static_assert(kSum.evaluate(2.0) == 6.0 / 16.0 + 1.0, "6/2^4 + 8/8");
+
+// Past 22! the table is rounded; the compiler rounds these exact decimal literals correctly
+static_assert(Laplace::factorial(22) == 1124000727777607680000.0, "exact");
+static_assert(Laplace::factorial(23) == 25852016738884976640000.0, "first rounded entry");
+static_assert(Laplace::factorial(100) == 93326215443944152681699238856266700490715968264381621468592963895217599993229915608941463976156518286253697920827223758251185210916864000000000000000000000000.0,
+              "100!");
+
+// 170! is the last factorial a double holds
+static_assert(ct::laplace("t^170").terms[0].gain == Laplace::factorial(170), "170!");
+
+// Past it the coefficient would be +inf, so constant evaluation throws and the build fails:
+//   constexpr auto overflow = ct::laplace("t^171");          // n! overflows past n = 170
+//   constexpr auto huge = ct::laplace("1000*t^170");          // Transform coefficient is not finite
+
+// ct::laplace and the run-time table give the same F(s) for the same line.
+bool same_as_table(const char* input) {
+    std::vector<Laplace::RationalFunction> compiled = ct::laplace(input).to_runtime();
+    Parser parser;
+    std::vector<ParsedTerm> terms = parser.parse(input);
+    if (compiled.size() != terms.size()) return false;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        Laplace::RationalFunction table = Laplace::transform_term(terms[i]);
+        if (compiled[i].power != table.power || compiled[i].shift != table.shift) return false;
+        for (std::complex<double> s : {std::complex<double>(3.0), std::complex<double>(2.0, 1.0)}) {
+            std::complex<double> a = compiled[i].evaluate(s), b = table.evaluate(s);
+            if (!close_to(a.real(), b.real()) || !close_to(a.imag(), b.imag())) return false;
+        }
+    }
+    return true;
+}
+
+void test_matches_table() {
+    const char* inputs[] = {
+        "t^2*exp(-3t)", "3*exp(-2*t)*sin(5*t)", "t^3 + 4*cos(2t)", "t*cosh(2*t)", "-2*t*exp(t)*sin(PI*t)",
+        "exp(-0.5*t)*sinh(3*t) - 7", "t^5*exp(2PI)", "sin(2)", "e^(-t)*cos(3t)", "t^170",
+    };
+    for (const char* input : inputs) CHECK(same_as_table(input));
+}
+
+void test_overflow_throws() {
+    for (const char* input : {"t^171", "1000*t^170", "t^10000000000"}) {
+        bool threw = false;
+        try {
+            ct::laplace(input);
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+}
+
+} // namespace
+
+void run_constexpr_laplace_tests() {
+    test_matches_table();
+    test_overflow_throws();
+}
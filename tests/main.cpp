@@ -0,0 +1,13 @@
+#include "check.h"
+
+int main() {
+    run_parser_tests();
+    run_transform_tests();
+    run_constexpr_laplace_tests();
+    if (check_failures() != 0) {
+        std::cerr << check_failures() << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}
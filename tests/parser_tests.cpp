@@ -0,0 +1,111 @@
+#include "canonical_form.h"
+#include "check.h"
+#include "parser.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Power of t in a term of a polynomial: 0 for CONSTANT, the parameter for T_POW_N.
+double t_power(const ParsedTerm& term) {
+    return term.type == FunctionType::CONSTANT ? 0.0 : term.parameters[0];
+}
+
+void test_power_of_sum() {
+    Parser parser;
+    // Pascal's triangle by the row, in double, as the expansion adds up like products
+    double binomial[65] = {1.0};
+    for (int n = 1; n <= 64; ++n) {
+        for (int k = n; k > 0; --k) binomial[k] += binomial[k - 1];
+    }
+    const std::vector<ParsedTerm>& terms = parser.parse("(t+1)^64");
+    CHECK(terms.size() == 65);
+    for (const ParsedTerm& term : terms) {
+        CHECK(term.type == FunctionType::CONSTANT || term.type == FunctionType::T_POW_N);
+        int k = static_cast<int>(t_power(term));
+        CHECK(k >= 0 && k <= 64 && close_to(term.coefficient, binomial[k]));
+    }
+
+    CHECK(parser.parse("(t+1)^20").size() == 21);
+    CHECK(parser.parse("(t+1)*(t+1)*(t+1)").size() == 4);
+    CHECK(parser.parse("(t+1)^64*(t+2)^64").size() == 129);
+}
+
+bool rejects(const char* input) {
+    Parser parser;
+    try {
+        parser.parse(input);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// The exponential in t: EXP with parameter a, read through both the flat and the DAG path.
+bool is_exp(const char* input, double a, double coefficient = 1.0) {
+    Parser parser;
+    const std::vector<ParsedTerm>& terms = parser.parse(input);
+    return terms.size() == 1 && terms[0].type == FunctionType::EXP && close_to(terms[0].parameters[0], a) &&
+           close_to(terms[0].coefficient, coefficient);
+}
+
+void test_powers_of_e() {
+    // e^(x) is exp(x), shorthand included, as before e^ took anything else
+    CHECK(is_exp("e^(2)", 2.0));
+    CHECK(is_exp("e^(-2*t)", -2.0));
+    CHECK(is_exp("e^(2*t + 1)", 2.0, M_E));
+    CHECK(is_exp("e^(t)^2", 2.0));
+    CHECK(is_exp("(e^t)^2", 2.0));
+
+    // Without parentheses the exponent must have t in it
+    CHECK(is_exp("e^t", 1.0));
+    CHECK(is_exp("e^-t", -1.0));
+    CHECK(is_exp("3*e^-t", -1.0, 3.0));
+    CHECK(rejects("e^2"));
+    CHECK(rejects("e^2*t"));   // Neither e^2 * t nor exp(2*t)
+    CHECK(rejects("e^-2t"));
+    CHECK(rejects("e^t^2"));   // e^(t^2), not (e^t)^2
+    CHECK(rejects("e"));
+
+    // Powers group to the right
+    Parser parser;
+    const std::vector<ParsedTerm>& terms = parser.parse("t^2^3");
+    CHECK(terms.size() == 1 && terms[0].type == FunctionType::T_POW_N && terms[0].parameters[0] == 8.0);
+}
+
+void test_juxtaposition() {
+    Parser parser;
+    const std::vector<ParsedTerm>& terms = parser.parse("2 PI t sin(3t)");
+    CHECK(terms.size() == 1 && terms[0].type == FunctionType::T_SIN && close_to(terms[0].coefficient, 2.0 * M_PI));
+    CHECK(parser.parse("3(t + 1)").size() == 2);
+
+    // A number never multiplies the factor before it
+    CHECK(rejects("2 3"));
+    CHECK(rejects("t 2"));
+    CHECK(rejects("sin(2 3 t)"));
+    CHECK(rejects("t^2 3"));
+}
+
+void test_canonical_key() {
+    Parser parser;
+    std::string key = Laplace::canonical_key(parser.parse("t + sin(2t) - 3"));
+    CHECK(key == Laplace::canonical_key(parser.parse("-3 + sin(2*t) + t")));
+
+    // 0 * e^1000 is NaN, which has no place in the sorted key
+    bool rejected = false;
+    try {
+        Laplace::canonical_key(parser.parse("0*exp(t+1000)"));
+    } catch (const std::domain_error&) {
+        rejected = true;
+    }
+    CHECK(rejected);
+}
+
+} // namespace
+
+void run_parser_tests() {
+    test_power_of_sum();
+    test_powers_of_e();
+    test_juxtaposition();
+    test_canonical_key();
+}
@@ -0,0 +1,66 @@
+#include "check.h"
+#include "numerical_transform.h"
+#include "parser.h"
+#include "transform_registry.h"
+#include <complex>
+#include <stdexcept>
+
+namespace {
+
+// F(s) from the transform table, as the batch tool answers a line with a closed form.
+std::complex<double> closed_form(const char* input, std::complex<double> s) {
+    Parser parser;
+    std::complex<double> sum = 0.0;
+    for (const ParsedTerm& term : parser.parse(input)) sum += Laplace::transform_term(term).evaluate(s);
+    return sum;
+}
+
+// F(s) by quadrature of the compiled f(t), the --numeric fallback.
+std::complex<double> numeric(const char* input, std::complex<double> s) {
+    Laplace::TimeFunction f(input);
+    return Laplace::NumericalTransform(f)(s).value;
+}
+
+bool solved_alike(const char* input, std::complex<double> s) {
+    std::complex<double> exact = closed_form(input, s);
+    std::complex<double> quadrature = numeric(input, s);
+    return close_to(quadrature.real(), exact.real(), 1e-8) && close_to(quadrature.imag(), exact.imag(), 1e-8);
+}
+
+// A line must mean the same f(t) whichever path answers it.
+void test_both_paths_agree() {
+    const char* inputs[] = {
+        "sin(2)", "cos(0.5) + 2*t", "exp(-1)*t", "sinh(0.5)", "3*cos(PI)", "t^2*exp(-3*t)", "sin(2*t + 1)",
+        "e^(1)*t", "e^(-1)^2", "e^-t*cos(2)",
+    };
+    for (const char* input : inputs) {
+        CHECK(solved_alike(input, 3.0));
+        CHECK(solved_alike(input, {2.0, 1.0}));
+    }
+
+    // "2 3" is a typo on both paths, not 6
+    bool compiled = true;
+    try {
+        Laplace::TimeFunction f("2 3");
+    } catch (const std::runtime_error&) {
+        compiled = false;
+    }
+    CHECK(!compiled);
+
+    // Two oscillations have no table row, so only quadrature answers this one; with sin(2)
+    // read as sin(2t) it is (cos(t) - cos(3t))/2, or 0.2 at s = 1
+    bool rejected = false;
+    try {
+        closed_form("sin(2)*sin(t)", 1.0);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    CHECK(rejected);
+    CHECK(close_to(numeric("sin(2)*sin(t)", 1.0).real(), 0.2, 1e-9));
+}
+
+} // namespace
+
+void run_transform_tests() {
+    test_both_paths_agree();
+}